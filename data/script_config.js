@@ -36,6 +36,11 @@ async function fetchConfig() {
       ? json.deepsleep_interval_min
       : (json.deepsleep_interval_s ? Math.ceil(json.deepsleep_interval_s / 60) : 5);
     document.getElementById('deepsleep_interval_min').value = deepMin || 5;
+    document.getElementById('mqtt_deadband_temp_c').value =
+      (typeof json.mqtt_deadband_temp_c !== 'undefined') ? json.mqtt_deadband_temp_c : 0.2;
+    document.getElementById('mqtt_deadband_hum_pct').value =
+      (typeof json.mqtt_deadband_hum_pct !== 'undefined') ? json.mqtt_deadband_hum_pct : 1.0;
+    document.getElementById('mqtt_max_silence_min').value = json.mqtt_max_silence_min || 60;
 
     document.getElementById('device_name').value = json.device_name || '';
     document.getElementById('admin_user').value = json.admin_user || '';
@@ -50,6 +55,14 @@ async function fetchConfig() {
     else
       document.getElementById('hum_offset').value = 0;
 
+    // sensor filtering
+    document.getElementById('median_n').value = json.median_n || 5;
+    document.getElementById('median_delay_ms').value =
+      (typeof json.median_delay_ms !== 'undefined') ? json.median_delay_ms : 50;
+    document.getElementById('avg_alpha').value = json.avg_alpha || 0.25;
+    document.getElementById('avg_alpha_hum').value = json.avg_alpha_hum || 0.25;
+    document.getElementById('avg_alpha_batt').value = json.avg_alpha_batt || 0.1;
+
     setSelectValueOrAdd(
       document.getElementById('tz_string'),
       json.tz_string || 'CET-1CEST,M3.5.0/2,M10.5.0/3'
@@ -80,6 +93,12 @@ function gatherConfig() {
   obj.interactive_timeout_min = (timeoutMin && timeoutMin > 0) ? timeoutMin : 5;
   const deepMin = parseInt(document.getElementById('deepsleep_interval_min').value);
   obj.deepsleep_interval_min = (deepMin && deepMin > 0) ? deepMin : 5;
+  const dbt = parseFloat(document.getElementById('mqtt_deadband_temp_c').value);
+  obj.mqtt_deadband_temp_c = isNaN(dbt) || dbt < 0 ? 0.0 : dbt;
+  const dbh = parseFloat(document.getElementById('mqtt_deadband_hum_pct').value);
+  obj.mqtt_deadband_hum_pct = isNaN(dbh) || dbh < 0 ? 0.0 : dbh;
+  const silence = parseInt(document.getElementById('mqtt_max_silence_min').value);
+  obj.mqtt_max_silence_min = (silence && silence > 0) ? silence : 60;
 
   obj.device_name = document.getElementById('device_name').value || '';
   obj.admin_user = document.getElementById('admin_user').value || '';
@@ -94,6 +113,16 @@ function gatherConfig() {
   const ho = parseFloat(document.getElementById('hum_offset').value);
   obj.hum_offset_pct = isNaN(ho) ? 0.0 : ho;
 
+  // sensor filtering
+  const mn = parseInt(document.getElementById('median_n').value);
+  obj.median_n = (mn >= 1 && mn <= 15) ? mn : 5;
+  const md = parseInt(document.getElementById('median_delay_ms').value);
+  obj.median_delay_ms = (md >= 0 && md <= 1000) ? md : 50;
+  for (const id of ['avg_alpha', 'avg_alpha_hum', 'avg_alpha_batt']) {
+    const a = parseFloat(document.getElementById(id).value);
+    if (a > 0 && a <= 1) obj[id] = a;
+  }
+
   return obj;
 }
 
@@ -242,36 +271,59 @@ document.getElementById('wifi_scan_list').addEventListener('change', (e) => {
   }
 });
 
-// Auto-refresh logs and act as ping using the unified /api/dashboard endpoint
-async function refreshLogsAndPing() {
+// Live logs pushed by the device over Server-Sent Events; the open stream also keeps
+// the device in interactive mode. Falls back to polling /api/dashboard with a log cursor.
+const MAX_LOG_LINES = 300;
+
+function appendLogs(logs, reset) {
   const pre = document.getElementById('logOutput');
-  try {
-    const res = await fetch('/api/dashboard');
-    if (res.ok) {
-      const j = await res.json();
-      if (j && j.ok) {
-        if (pre && j.logs !== undefined) {
-          // Only update if content changed (reduce flickering)
-          if (pre.innerText !== j.logs) {
-            pre.innerText = j.logs;
-            pre.scrollTop = pre.scrollHeight;
-          }
-        }
-        // Optionally reflect ping status briefly
-        const statusEl = document.getElementById('status');
-        if (statusEl) {
-          statusEl.innerText = 'Device reachable';
-          statusEl.style.color = 'green';
-          setTimeout(() => { statusEl.innerText = ''; }, 1500);
+  if (!pre) return;
+  if (reset) pre.innerText = '';
+  if (!logs) return;
+  const lines = (pre.innerText + logs).split('\n');
+  pre.innerText = lines.slice(-MAX_LOG_LINES - 1).join('\n');
+  pre.scrollTop = pre.scrollHeight;
+}
+
+function showReachable() {
+  const statusEl = document.getElementById('status');
+  if (statusEl) {
+    statusEl.innerText = 'Device reachable';
+    statusEl.style.color = 'green';
+    setTimeout(() => { statusEl.innerText = ''; }, 1500);
+  }
+}
+
+if (window.EventSource) {
+  let lastLogId = 0;
+  const es = new EventSource('/api/events');
+  es.addEventListener('open', showReachable);
+  es.addEventListener('log', (e) => {
+    const id = parseInt(e.lastEventId || '0', 10);
+    // First batch, or ids went backwards (device restarted): start over
+    appendLogs(e.data + '\n', lastLogId === 0 || id < lastLogId);
+    lastLogId = id;
+  });
+} else {
+  let logCursor = 0;
+  async function refreshLogsAndPing() {
+    try {
+      const res = await fetch('/api/dashboard?since=' + logCursor);
+      if (res.ok) {
+        const j = await res.json();
+        if (j && j.ok) {
+          // Cursor went backwards: the device restarted, drop the old lines
+          appendLogs(j.logs, logCursor === 0 || j.next < logCursor);
+          logCursor = j.next;
+          showReachable();
         }
       }
+    } catch (e) {
+      // silently ignore fetch errors during auto-refresh
     }
-  } catch (e) {
-    // silently ignore fetch errors during auto-refresh
   }
+  setInterval(refreshLogsAndPing, 2000);
+  refreshLogsAndPing(); // initial call
 }
 
-setInterval(refreshLogsAndPing, 2000);
-refreshLogsAndPing(); // initial call
-
 fetchConfig();
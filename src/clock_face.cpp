@@ -0,0 +1,159 @@
+#include "clock_face.h"
+#include "config_manager.h"
+#include "epd_frame.h"
+#include "face_layer.h"
+#include "fonts.h"
+
+static_assert(sizeof(faceLayer) == EPD_FRAME_BYTES, "face_layer.h does not match the frame size");
+
+static const char *const days[7] = {"SU", "MO", "TU", "WE", "TH", "FR", "SA"};
+
+// Clear a text area (with padding) to a specific color before re-drawing dynamic content
+static void clearTextArea(FrameCanvas &frame, const char *text, int cursorX, int cursorY, uint16_t pad,
+                          uint16_t color = GxEPD_WHITE)
+{
+    int16_t bx, by;
+    uint16_t bw, bh;
+    frame.getTextBounds(text, cursorX, cursorY, &bx, &by, &bw, &bh);
+    int rx = bx - (int)pad;
+    int ry = by - (int)pad;
+    int rw = (int)bw + (int)pad * 2;
+    int rh = (int)bh + (int)pad * 2;
+    if (rx < 0)
+        rx = 0;
+    if (ry < 0)
+        ry = 0;
+    if (rx + rw > (int)frame.width())
+        rw = (int)frame.width() - rx;
+    if (ry + rh > (int)frame.height())
+        rh = (int)frame.height() - ry;
+    frame.fillRect(rx, ry, rw, rh, color);
+}
+
+void clockFaceBegin(FrameCanvas &frame)
+{
+    frame.setGlyphAtlas(&DSEG7_Classic_Bold_36, '0', ':');
+}
+
+void clockFaceRender(FrameCanvas &frame, const ClockFaceText &text, const AppConfig &cfg)
+{
+    // Static background, shapes and labels are pre-composited by tools/compose_face.py
+    memcpy(frame.getBuffer(), faceLayer, EPD_FRAME_BYTES);
+
+    for (int i = 0; i < text.batterySegments; i++)
+        frame.fillRect(154 + (i * 7), 12, 4, 8, GxEPD_BLACK);
+
+    frame.setTextColor(GxEPD_BLACK);
+    frame.setFont(&DSEG7_Classic_Bold_36);
+    clearTextArea(frame, text.time, 18, 130, 2);
+    frame.setCursor(18, 130);
+    frame.print(text.time);
+
+    frame.setFont(&DejaVu_Sans_Condensed_Bold_15);
+    frame.setCursor(60, 177);
+    clearTextArea(frame, text.temp, 60, 177, 2);
+    frame.print(text.temp);
+    frame.setCursor(135, 177);
+    clearTextArea(frame, text.humidity, 135, 177, 2);
+    frame.print(text.humidity);
+    frame.setCursor(120, 78);
+    // Display "MQTT" if enabled
+    if (cfg.mqtt_enabled)
+    {
+        clearTextArea(frame, "MQTT", 120, 78, 2);
+        frame.print("MQTT");
+    }
+
+    frame.setTextColor(GxEPD_WHITE);
+    frame.setCursor(156, 110);
+    frame.print(days[text.weekday % 7]);
+
+    frame.setFont(&DejaVu_Sans_Condensed_Bold_18);
+    frame.setTextColor(GxEPD_WHITE);
+    clearTextArea(frame, text.date, 27, 76, 3, GxEPD_BLACK);
+    frame.setCursor(27, 76);
+    frame.print(text.date);
+
+    frame.setTextColor(GxEPD_BLACK);
+    frame.setFont(&DejaVu_Sans_Condensed_Bold_23);
+    // Show application version instead of static label
+    frame.setCursor(120, 62);
+    frame.print(cfg.app_version);
+
+    // Wi-Fi status: AP/STA + IP
+    frame.setFont(&DejaVu_Sans_Condensed_Bold_15); // small readable font
+    int16_t tbx, tby;
+    uint16_t tbw, tbh;
+    const int textX = 40;
+    const int textY = 200;
+    frame.getTextBounds(text.wifi, textX, textY, &tbx, &tby, &tbw, &tbh);
+    int pad = 4; // small padding around text
+    int rectX = tbx - pad;
+    int rectY = tby - pad;
+    int rectW = tbw + (pad * 2);
+    int rectH = tbh + (pad * 2);
+    if (rectX < 0)
+        rectX = 0;
+    if (rectY < 0)
+        rectY = 0;
+    if (rectX + rectW > 200)
+        rectW = 200 - rectX;
+    if (rectY + rectH > 200)
+        rectH = 200 - rectY;
+    frame.fillRect(rectX, rectY, rectW, rectH, GxEPD_WHITE);
+    frame.setTextColor(GxEPD_BLACK);
+    // Bottom of the screen (y ~= 195 on a 200px tall display)
+    frame.setCursor(textX, textY);
+    frame.print(text.wifi);
+
+    // Display device name at the top-right area (replaces VOLOS from bitmap)
+    const char *devName = cfg.device_name;
+    if (devName && strlen(devName) > 0)
+    {
+        frame.setFont(&DejaVu_Sans_Condensed_Bold_18);
+        int16_t nbx, nby;
+        uint16_t nbw, nbh;
+        const int nameX = 30;
+        const int nameY = 25;
+        frame.getTextBounds(devName, nameX, nameY, &nbx, &nby, &nbw, &nbh);
+        int npad = 4;
+        int nrectX = nbx - npad;
+        int nrectY = nby - npad;
+        int nrectW = nbw + (npad * 2);
+        int nrectH = nbh + (npad * 2);
+        if (nrectX < 0)
+            nrectX = 0;
+        if (nrectY < 0)
+            nrectY = 0;
+        if (nrectX + nrectW > 200)
+            nrectW = 200 - nrectX;
+        if (nrectY + nrectH > 200)
+            nrectH = 200 - nrectY;
+        frame.fillRect(nrectX, nrectY, nrectW, nrectH, GxEPD_WHITE);
+        frame.setTextColor(GxEPD_BLACK);
+        frame.setCursor(nameX, nameY);
+        frame.print(devName);
+    }
+
+    // If requested, draw a small sleep indicator overlay in the top-left corner
+    if (text.sleepIndicator)
+    {
+        frame.setFont(&DejaVu_Sans_Condensed_Bold_15);
+        frame.setTextColor(GxEPD_WHITE);
+        frame.fillRect(0, 0, 28, 18, GxEPD_BLACK);
+        frame.setCursor(4, 14);
+        frame.print("Zz");
+    }
+}
+
+void clockFaceDrawPowerOff(Adafruit_GFX &gfx)
+{
+    gfx.fillRect(0, 0, gfx.width(), gfx.height(), GxEPD_WHITE);
+    gfx.setTextColor(GxEPD_BLACK);
+    gfx.setFont(&DejaVu_Sans_Condensed_Bold_18);
+    gfx.setCursor(36, 102);
+    gfx.print("Powering off");
+    gfx.setFont(&DejaVu_Sans_Condensed_Bold_15);
+    gfx.setCursor(36, 126);
+    gfx.print("VBAT disabled");
+}
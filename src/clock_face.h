@@ -0,0 +1,27 @@
+#pragma once
+#include <Arduino.h>
+#include "frame_canvas.h"
+
+struct AppConfig;
+
+// Dynamic content of the clock face, already formatted by the caller
+struct ClockFaceText
+{
+    const char *time;        // HH:MM
+    const char *date;        // DD/MM/YY
+    const char *temp;        // degrees C
+    const char *humidity;    // %RH
+    const char *wifi;        // "STA <ip>", "AP <ip>" or "WiFi OFF"
+    uint8_t weekday;         // 0 = Sunday
+    uint8_t batterySegments; // 0..5
+    bool sleepIndicator;     // "Zz" overlay in the top-left corner
+};
+
+// Keep the clock digits pre-expanded in the canvas glyph atlas (they are drawn on every wake)
+void clockFaceBegin(FrameCanvas &frame);
+
+// Draw the whole clock face into the offscreen frame (EPD_FRAME_WIDTH x EPD_FRAME_HEIGHT)
+void clockFaceRender(FrameCanvas &frame, const ClockFaceText &text, const AppConfig &cfg);
+
+// Confirmation shown before VBAT is cut, drawn on any GFX target (the paged panel buffer)
+void clockFaceDrawPowerOff(Adafruit_GFX &gfx);
@@ -5,13 +5,13 @@
 
 // ---------- DEBUG ----------
 #include <stdio.h>
-
-// Forward declaration for log buffer append (implemented in utils.cpp)
-void appendLog(const char *msg);
+#include "log_ring.h"
 
 #define DEBUG true
-#define DEBUG_PRINT(x)             if (DEBUG) { Serial.println(x); appendLog(x); }
-#define DEBUG_PRINTF(...) do { if (DEBUG) { char _dbgbuf[256]; snprintf(_dbgbuf, sizeof(_dbgbuf), __VA_ARGS__); Serial.printf(__VA_ARGS__); appendLog(_dbgbuf); } } while(0)
+// Mirror log lines to the serial console (the web log ring is always fed)
+#define LOG_SERIAL true
+#define DEBUG_PRINT(x) do { if (DEBUG) { if (LOG_SERIAL) Serial.println(x); logPrint(x); } } while (0)
+#define DEBUG_PRINTF(...) do { if (DEBUG) { if (LOG_SERIAL) Serial.printf(__VA_ARGS__); logPrintf(__VA_ARGS__); } } while (0)
 
 // Last interactive "touch" (HTTP ping)
 extern std::atomic<uint32_t> interactiveLastTouchMs;
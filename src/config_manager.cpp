@@ -25,6 +25,13 @@ bool ConfigManager::begin()
     if (!exists)
     {
         DEBUG_PRINT("[ConfigManager] No configuration found. Applying default values...");
+        {
+            // Zero is a valid setting for these, so applyDefaultsIfNeeded() cannot fill them in
+            std::lock_guard<std::mutex> lk(mutex_);
+            config_.mqtt_deadband_temp_c = 0.2f;
+            config_.mqtt_deadband_hum_pct = 1.0f;
+            config_.mqtt_max_silence_min = 60;
+        }
         applyDefaultsIfNeeded();
         save();
         return true;
@@ -56,6 +63,15 @@ void ConfigManager::applyDefaultsIfNeeded()
         config_.deepsleep_interval_min = 1;
         DEBUG_PRINT("  -> deepsleep_interval_min clamped to 1 (MQTT cadence)");
     }
+    if (config_.mqtt_deadband_temp_c < 0.0f)
+        config_.mqtt_deadband_temp_c = 0.0f;
+    if (config_.mqtt_deadband_hum_pct < 0.0f)
+        config_.mqtt_deadband_hum_pct = 0.0f;
+    if (config_.mqtt_max_silence_min < config_.deepsleep_interval_min)
+    {
+        config_.mqtt_max_silence_min = config_.deepsleep_interval_min;
+        DEBUG_PRINT("  -> mqtt_max_silence_min raised to the MQTT cadence");
+    }
     if (config_.measure_interval_ms < 50)
     {
         config_.measure_interval_ms = 1000;
@@ -97,6 +113,16 @@ void ConfigManager::applyDefaultsIfNeeded()
         config_.avg_alpha = 0.25f;
         DEBUG_PRINT("  -> avg_alpha set to 0.25");
     }
+    if (config_.avg_alpha_hum <= 0.0f || config_.avg_alpha_hum > 1.0f)
+    {
+        config_.avg_alpha_hum = 0.25f;
+        DEBUG_PRINT("  -> avg_alpha_hum set to 0.25");
+    }
+    if (config_.avg_alpha_batt <= 0.0f || config_.avg_alpha_batt > 1.0f)
+    {
+        config_.avg_alpha_batt = 0.1f;
+        DEBUG_PRINT("  -> avg_alpha_batt set to 0.1");
+    }
     if (config_.median_n == 0 || config_.median_n > 15)
     {
         config_.median_n = 5;
@@ -122,6 +148,21 @@ void ConfigManager::applyDefaultsIfNeeded()
         strcpy(config_.tz_string, "CET-1CEST,M3.5.0/2,M10.5.0/3");
         DEBUG_PRINT("  -> tz_string set to Europe/Paris (DST auto)");
     }
+
+    // Every load/update path ends here, so readers only ever see defaulted values
+    publishLocked();
+}
+
+void ConfigManager::publishLocked()
+{
+    // Fill the idle buffer, then flip: readers of the live buffer are never written to
+    const uint32_t next = generation_.load(std::memory_order_relaxed) + 1;
+    const uint32_t seq = writeSeq_.load(std::memory_order_relaxed);
+    writeSeq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    snapshots_[next & 1] = config_;
+    writeSeq_.store(seq + 2, std::memory_order_release);
+    generation_.store(next, std::memory_order_release);
 }
 
 bool ConfigManager::loadFromPreferences()
@@ -145,6 +186,9 @@ bool ConfigManager::loadFromPreferences()
     prefs.getString("mqtt_user", config_.mqtt_user, sizeof(config_.mqtt_user));
     prefs.getString("mqtt_pass", config_.mqtt_pass, sizeof(config_.mqtt_pass));
     prefs.getString("mqtt_topic", config_.mqtt_topic, sizeof(config_.mqtt_topic));
+    config_.mqtt_deadband_temp_c = prefs.getFloat("mqtt_db_t", 0.2f);
+    config_.mqtt_deadband_hum_pct = prefs.getFloat("mqtt_db_h", 1.0f);
+    config_.mqtt_max_silence_min = prefs.getUInt("mqtt_silence", 60);
 
     config_.measure_interval_ms = prefs.getUInt("meas_int_ms", 1000);
     config_.measure_offset_cm = prefs.getFloat("meas_off_cm", 0.0f);
@@ -153,6 +197,8 @@ bool ConfigManager::loadFromPreferences()
     config_.hum_offset_pct = prefs.getFloat("hum_off_pct", 0.0f);
 
     config_.avg_alpha = prefs.getFloat("avg_alpha", 0.25f);
+    config_.avg_alpha_hum = prefs.getFloat("avg_alpha_hum", 0.25f);
+    config_.avg_alpha_batt = prefs.getFloat("avg_alpha_batt", 0.1f);
     config_.median_n = prefs.getUShort("median_n", 5);
     config_.median_delay_ms = prefs.getUShort("median_delay_ms", 50);
     config_.filter_min_cm = prefs.getFloat("f_min_cm", 2.0f);
@@ -230,12 +276,17 @@ bool ConfigManager::save()
     prefs.putString("mqtt_user", config_.mqtt_user);
     prefs.putString("mqtt_pass", config_.mqtt_pass);
     prefs.putString("mqtt_topic", config_.mqtt_topic);
+    prefs.putFloat("mqtt_db_t", config_.mqtt_deadband_temp_c);
+    prefs.putFloat("mqtt_db_h", config_.mqtt_deadband_hum_pct);
+    prefs.putUInt("mqtt_silence", config_.mqtt_max_silence_min);
 
     prefs.putUInt("meas_int_ms", config_.measure_interval_ms);
     prefs.putFloat("meas_off_cm", config_.measure_offset_cm);
     prefs.putFloat("temp_off_c", config_.temp_offset_c);
     prefs.putFloat("hum_off_pct", config_.hum_offset_pct);
     prefs.putFloat("avg_alpha", config_.avg_alpha);
+    prefs.putFloat("avg_alpha_hum", config_.avg_alpha_hum);
+    prefs.putFloat("avg_alpha_batt", config_.avg_alpha_batt);
     prefs.putUShort("median_n", config_.median_n);
     prefs.putUShort("median_delay_ms", config_.median_delay_ms);
     prefs.putFloat("f_min_cm", config_.filter_min_cm);
@@ -270,12 +321,17 @@ String ConfigManager::toJsonString()
     doc["mqtt_user"] = config_.mqtt_user;
     doc["mqtt_pass"] = "*****";
     doc["mqtt_topic"] = config_.mqtt_topic;
+    doc["mqtt_deadband_temp_c"] = config_.mqtt_deadband_temp_c;
+    doc["mqtt_deadband_hum_pct"] = config_.mqtt_deadband_hum_pct;
+    doc["mqtt_max_silence_min"] = config_.mqtt_max_silence_min;
 
     doc["measure_interval_ms"] = config_.measure_interval_ms;
     doc["measure_offset_cm"] = config_.measure_offset_cm;
     doc["temp_offset_c"] = config_.temp_offset_c;
     doc["hum_offset_pct"] = config_.hum_offset_pct;
     doc["avg_alpha"] = config_.avg_alpha;
+    doc["avg_alpha_hum"] = config_.avg_alpha_hum;
+    doc["avg_alpha_batt"] = config_.avg_alpha_batt;
     doc["median_n"] = config_.median_n;
     doc["median_delay_ms"] = config_.median_delay_ms;
     doc["filter_min_cm"] = config_.filter_min_cm;
@@ -297,7 +353,7 @@ String ConfigManager::toJsonString()
     return s;
 }
 
-bool ConfigManager::updateFromJson(const String &json)
+bool ConfigManager::updateFromJson(const String &json, bool saveAsync)
 {
     DEBUG_PRINT("[ConfigManager] Updating from JSON...");
 
@@ -337,6 +393,12 @@ bool ConfigManager::updateFromJson(const String &json)
         }
         if (doc["mqtt_topic"].is<const char *>())
             strlcpy(config_.mqtt_topic, doc["mqtt_topic"], sizeof(config_.mqtt_topic));
+        if (doc["mqtt_deadband_temp_c"].is<float>())
+            config_.mqtt_deadband_temp_c = doc["mqtt_deadband_temp_c"];
+        if (doc["mqtt_deadband_hum_pct"].is<float>())
+            config_.mqtt_deadband_hum_pct = doc["mqtt_deadband_hum_pct"];
+        if (doc["mqtt_max_silence_min"].is<uint32_t>())
+            config_.mqtt_max_silence_min = doc["mqtt_max_silence_min"];
 
         if (doc["measure_interval_ms"].is<uint32_t>())
             config_.measure_interval_ms = doc["measure_interval_ms"];
@@ -349,6 +411,10 @@ bool ConfigManager::updateFromJson(const String &json)
 
         if (doc["avg_alpha"].is<float>())
             config_.avg_alpha = doc["avg_alpha"];
+        if (doc["avg_alpha_hum"].is<float>())
+            config_.avg_alpha_hum = doc["avg_alpha_hum"];
+        if (doc["avg_alpha_batt"].is<float>())
+            config_.avg_alpha_batt = doc["avg_alpha_batt"];
         if (doc["median_n"].is<uint16_t>())
             config_.median_n = doc["median_n"];
         if (doc["median_delay_ms"].is<uint16_t>())
@@ -390,6 +456,9 @@ bool ConfigManager::updateFromJson(const String &json)
 
     applyDefaultsIfNeeded();
 
+    if (!saveAsync)
+        return true;
+
     xTaskCreate(
         [](void *)
         {
@@ -409,74 +478,90 @@ AppConfig ConfigManager::getConfig()
     return config_;
 }
 
+const AppConfig &ConfigManager::snapshot() const
+{
+    return snapshots_[generation_.load(std::memory_order_acquire) & 1];
+}
+
+uint32_t ConfigManager::copySnapshot(AppConfig &out) const
+{
+    for (;;)
+    {
+        const uint32_t seq = writeSeq_.load(std::memory_order_acquire);
+        const uint32_t gen = generation_.load(std::memory_order_acquire);
+        if (seq & 1)
+        {
+            yield();
+            continue;
+        }
+        out = snapshots_[gen & 1];
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (writeSeq_.load(std::memory_order_relaxed) == seq)
+            return gen;
+    }
+}
+
+uint32_t ConfigManager::generation() const
+{
+    return generation_.load(std::memory_order_acquire);
+}
+
 uint32_t ConfigManager::getMeasureIntervalMs()
 {
-    std::lock_guard<std::mutex> lk(mutex_);
-    return config_.measure_interval_ms;
+    return snapshot().measure_interval_ms;
 }
 
 float ConfigManager::getMeasureOffsetCm()
 {
-    std::lock_guard<std::mutex> lk(mutex_);
-    return config_.measure_offset_cm;
+    return snapshot().measure_offset_cm;
 }
 
 float ConfigManager::getRunningAverageAlpha()
 {
-    std::lock_guard<std::mutex> lk(mutex_);
-    return config_.avg_alpha;
+    return snapshot().avg_alpha;
 }
 
 uint16_t ConfigManager::getMedianSamples()
 {
-    std::lock_guard<std::mutex> lk(mutex_);
-    return config_.median_n;
+    return snapshot().median_n;
 }
 
 uint16_t ConfigManager::getMedianSampleDelayMs()
 {
-    std::lock_guard<std::mutex> lk(mutex_);
-    return config_.median_delay_ms;
+    return snapshot().median_delay_ms;
 }
 
 float ConfigManager::getFilterMinCm()
 {
-    std::lock_guard<std::mutex> lk(mutex_);
-    return config_.filter_min_cm;
+    return snapshot().filter_min_cm;
 }
 
 float ConfigManager::getFilterMaxCm()
 {
-    std::lock_guard<std::mutex> lk(mutex_);
-    return config_.filter_max_cm;
+    return snapshot().filter_max_cm;
 }
 
 float ConfigManager::getTempOffsetC()
 {
-    std::lock_guard<std::mutex> lk(mutex_);
-    return config_.temp_offset_c;
+    return snapshot().temp_offset_c;
 }
 
 float ConfigManager::getHumOffsetPct()
 {
-    std::lock_guard<std::mutex> lk(mutex_);
-    return config_.hum_offset_pct;
+    return snapshot().hum_offset_pct;
 }
 
 bool ConfigManager::isMQTTEnabled()
 {
-    std::lock_guard<std::mutex> lk(mutex_);
-    return config_.mqtt_enabled;
+    return snapshot().mqtt_enabled;
 }
 
 const char *ConfigManager::getAdminUser()
 {
-    std::lock_guard<std::mutex> lk(mutex_);
-    return config_.admin_user;
+    return snapshot().admin_user;
 }
 
 const char *ConfigManager::getAdminPass()
 {
-    std::lock_guard<std::mutex> lk(mutex_);
-    return config_.admin_pass;
+    return snapshot().admin_pass;
 }
@@ -2,6 +2,7 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <mutex>
+#include <atomic>
 
 #define WIFI_SSID_LEN 32
 #define WIFI_PASS_LEN 64
@@ -29,6 +30,11 @@ struct AppConfig
     char mqtt_user[MQTT_USER_LEN];
     char mqtt_pass[MQTT_PASS_LEN];
     char mqtt_topic[MQTT_TOPIC_LEN];
+    // Report on change: a reading is published when it moved at least this far from the last
+    // published one, or after max silence; both deadbands 0 = every reading
+    float mqtt_deadband_temp_c;
+    float mqtt_deadband_hum_pct;
+    uint32_t mqtt_max_silence_min;
 
     // ---- Measurement ----
     uint32_t measure_interval_ms;
@@ -38,9 +44,11 @@ struct AppConfig
     float hum_offset_pct;   // humidity offset in percent points
 
     // ---- Smoothing / filter ----
-    float avg_alpha;          // 0..1
-    uint16_t median_n;        // 1..15
-    uint16_t median_delay_ms; // 0..1000
+    float avg_alpha;          // 0..1, temperature EMA (1 = no smoothing)
+    float avg_alpha_hum;      // 0..1, humidity EMA
+    float avg_alpha_batt;     // 0..1, battery EMA
+    uint16_t median_n;        // 1..15 samples per reading, reduced to their median
+    uint16_t median_delay_ms; // 0..1000, spacing of the sensor samples
     float filter_min_cm;      // e.g. 2.0
     float filter_max_cm;      // e.g. 400.0
 
@@ -65,9 +73,22 @@ public:
     bool begin();
     bool save();
     String toJsonString();
-    bool updateFromJson(const String &json);
+    // Applies and publishes the fields present in json. The flash write runs on a separate
+    // task unless saveAsync is false, for callers that save() themselves.
+    bool updateFromJson(const String &json, bool saveAsync = true);
 
     AppConfig getConfig();
+    // Lock-free, copy-free view of the last published configuration. The reference stays
+    // consistent until the second publish after it was taken, so it is only safe on the task
+    // that publishes (the web server, which runs updateFromJson) or for reading one scalar
+    // field. Other tasks reading several fields use copySnapshot().
+    const AppConfig &snapshot() const;
+    // Consistent copy of the last published configuration from any task, seqlock style: the
+    // copy is retried when a publish overlapped it, the publisher never waits. Returns the
+    // generation that was copied.
+    uint32_t copySnapshot(AppConfig &out) const;
+    // Incremented each time a new configuration is published
+    uint32_t generation() const;
     uint32_t getMeasureIntervalMs();
     float getMeasureOffsetCm();
 
@@ -93,7 +114,14 @@ private:
 
     void applyDefaultsIfNeeded();
     bool loadFromPreferences();
+    void publishLocked();
 
+    // Writer-side working copy, only touched under mutex_
     AppConfig config_{};
     std::mutex mutex_;
+    // Double-buffered published copies; generation_ & 1 selects the live one
+    AppConfig snapshots_[2]{};
+    std::atomic<uint32_t> generation_{0};
+    // Odd while publishLocked() writes a buffer, for copySnapshot()
+    std::atomic<uint32_t> writeSeq_{0};
 };
@@ -0,0 +1,219 @@
+#include "epd_frame.h"
+#include "config.h"
+#include "perf.h"
+#include <freertos/semphr.h>
+#include <string.h>
+
+#define EPD_FRAME_MAGIC 0x45504446UL
+// Longest single block on BUSY; GxEPD2 re-checks the pin and its own timeout in between
+#define EPD_BUSY_SLICE_MS 100
+
+// Last frame pushed to the panel, kept in RTC memory so timer wakes can diff against it
+struct RetainedFrame
+{
+    uint32_t magic;
+    uint8_t pixels[EPD_FRAME_BYTES];
+};
+
+static RTC_DATA_ATTR RetainedFrame retainedFrame;
+
+// Background push: the semaphore is available while no push is running
+struct PushJob
+{
+    GxEPD2_154_D67 *epd;
+    const uint8_t *frame;
+    bool fullRefresh;
+    EpdWindow win;
+    uint32_t startUs;
+};
+
+static PushJob pushJob;
+
+// BUSY edge wait: the ISR releases the task blocked in busyCallback
+static SemaphoreHandle_t busyEdge = nullptr;
+static int8_t busyPin = -1;
+static uint8_t busyLevel = HIGH;
+static uint32_t busyBlockedUs = 0;
+
+static void IRAM_ATTR onBusyEdge()
+{
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(busyEdge, &woken);
+    if (woken)
+        portYIELD_FROM_ISR();
+}
+
+// Called by GxEPD2 in place of delay(1) while BUSY is active
+static void busyCallback(const void *)
+{
+    const uint32_t start = micros();
+    // A stale edge only ends one slice early: GxEPD2 re-reads the pin and calls again
+    if (digitalRead(busyPin) == busyLevel)
+        xSemaphoreTake(busyEdge, pdMS_TO_TICKS(EPD_BUSY_SLICE_MS));
+    busyBlockedUs += micros() - start;
+}
+
+void epdBusyWaitInstall(GxEPD2_154_D67 &epd, int8_t pin, uint8_t level)
+{
+    if (pin < 0)
+        return;
+    if (!busyEdge)
+    {
+        busyEdge = xSemaphoreCreateBinary();
+        if (!busyEdge)
+            return;
+    }
+    busyPin = pin;
+    busyLevel = level;
+    // Re-attached on every panel init: GxEPD2's init() reconfigures the pin
+    attachInterrupt(digitalPinToInterrupt(pin), onBusyEdge, (level == HIGH) ? FALLING : RISING);
+    epd.setBusyCallback(busyCallback);
+}
+
+bool epdFrameDiff(const uint8_t *frame, bool fullRefresh, EpdWindow &win)
+{
+    win = {0, 0, EPD_FRAME_WIDTH, EPD_FRAME_HEIGHT};
+    if (fullRefresh || retainedFrame.magic != EPD_FRAME_MAGIC)
+        return true;
+
+    int minRow = EPD_FRAME_HEIGHT, maxRow = -1;
+    int minCol = EPD_FRAME_STRIDE, maxCol = -1;
+    for (int row = 0; row < EPD_FRAME_HEIGHT; row++)
+    {
+        const uint8_t *cur = frame + row * EPD_FRAME_STRIDE;
+        const uint8_t *prev = retainedFrame.pixels + row * EPD_FRAME_STRIDE;
+        if (memcmp(cur, prev, EPD_FRAME_STRIDE) == 0)
+            continue;
+
+        if (minRow > row)
+            minRow = row;
+        maxRow = row;
+        for (int col = 0; col < EPD_FRAME_STRIDE; col++)
+        {
+            if (cur[col] == prev[col])
+                continue;
+            if (minCol > col)
+                minCol = col;
+            if (maxCol < col)
+                maxCol = col;
+        }
+    }
+
+    if (maxRow < 0)
+        return false;
+
+    // Union of changed rows/byte columns, so x and w stay 8-pixel aligned
+    win.x = (int16_t)(minCol * 8);
+    win.w = (int16_t)((maxCol - minCol + 1) * 8);
+    win.y = (int16_t)minRow;
+    win.h = (int16_t)(maxRow - minRow + 1);
+    return true;
+}
+
+void epdFramePush(GxEPD2_154_D67 &epd, const uint8_t *frame, bool fullRefresh, const EpdWindow &win)
+{
+    busyBlockedUs = 0;
+    if (fullRefresh)
+    {
+        epd.writeImageAgain(frame, 0, 0, EPD_FRAME_WIDTH, EPD_FRAME_HEIGHT);
+        epd.refresh(false);
+        DEBUG_PRINT("[EPD] Full refresh.");
+    }
+    else
+    {
+        if (retainedFrame.magic == EPD_FRAME_MAGIC)
+        {
+            // Controller RAM is lost while EPD_PWR is off: restore the previous image as partial-refresh baseline
+            epd.writeImagePartAgain(retainedFrame.pixels, win.x, win.y, EPD_FRAME_WIDTH, EPD_FRAME_HEIGHT,
+                                    win.x, win.y, win.w, win.h);
+        }
+        epd.writeImagePart(frame, win.x, win.y, EPD_FRAME_WIDTH, EPD_FRAME_HEIGHT, win.x, win.y, win.w, win.h);
+        epd.refresh(win.x, win.y, win.w, win.h);
+        epd.writeImagePartAgain(frame, win.x, win.y, EPD_FRAME_WIDTH, EPD_FRAME_HEIGHT, win.x, win.y, win.w, win.h);
+        DEBUG_PRINTF("[EPD] Partial refresh %dx%d @ %d,%d\n", win.w, win.h, win.x, win.y);
+    }
+
+    memcpy(retainedFrame.pixels, frame, EPD_FRAME_BYTES);
+    retainedFrame.magic = EPD_FRAME_MAGIC;
+    if (busyEdge)
+        perfRecord(PERF_EPD_BUSY, busyBlockedUs);
+}
+
+// Held while a push is running, i.e. while the panel is in use and retainedFrame being replaced.
+// Created on first use; whichever task gets there first (main loop or web server) creates it.
+static SemaphoreHandle_t panelIdleSem()
+{
+    static SemaphoreHandle_t sem = []
+    {
+        SemaphoreHandle_t s = xSemaphoreCreateBinary();
+        if (s)
+            xSemaphoreGive(s);
+        return s;
+    }();
+    return sem;
+}
+
+static void pushTask(void *)
+{
+    epdFramePush(*pushJob.epd, pushJob.frame, pushJob.fullRefresh, pushJob.win);
+    perfRecord(PERF_EPD_REFRESH, micros() - pushJob.startUs);
+    xSemaphoreGive(panelIdleSem());
+    vTaskDelete(nullptr);
+}
+
+void epdFramePushAsync(GxEPD2_154_D67 &epd, const uint8_t *frame, bool fullRefresh, const EpdWindow &win,
+                       uint32_t startUs)
+{
+    SemaphoreHandle_t panelIdle = panelIdleSem();
+    if (!panelIdle || xSemaphoreTake(panelIdle, portMAX_DELAY) != pdTRUE)
+    {
+        epdFramePush(epd, frame, fullRefresh, win);
+        perfRecord(PERF_EPD_REFRESH, micros() - startUs);
+        return;
+    }
+
+    pushJob = {&epd, frame, fullRefresh, win, startUs};
+    if (xTaskCreate(pushTask, "epdPush", 4096, nullptr, 1, nullptr) != pdPASS)
+    {
+        DEBUG_PRINT("[EPD][ERR] Push task creation failed, refreshing inline.");
+        epdFramePush(epd, frame, fullRefresh, win);
+        perfRecord(PERF_EPD_REFRESH, micros() - startUs);
+        xSemaphoreGive(panelIdle);
+    }
+}
+
+void epdFrameJoin()
+{
+    SemaphoreHandle_t panelIdle = panelIdleSem();
+    if (!panelIdle)
+        return;
+    const uint32_t start = micros();
+    const bool idle = xSemaphoreTake(panelIdle, 0) == pdTRUE;
+    if (!idle)
+        xSemaphoreTake(panelIdle, portMAX_DELAY);
+    xSemaphoreGive(panelIdle);
+    if (!idle)
+        perfRecord(PERF_EPD_JOIN, micros() - start);
+}
+
+EpdCopyResult epdFrameCopyRetained(uint8_t *out)
+{
+    SemaphoreHandle_t panelIdle = panelIdleSem();
+    if (!panelIdle || xSemaphoreTake(panelIdle, 0) != pdTRUE)
+        return EPD_COPY_BUSY;
+    const bool valid = retainedFrame.magic == EPD_FRAME_MAGIC;
+    if (valid)
+        memcpy(out, retainedFrame.pixels, EPD_FRAME_BYTES);
+    xSemaphoreGive(panelIdle);
+    return valid ? EPD_COPY_OK : EPD_COPY_NONE;
+}
+
+void epdFrameInvalidate()
+{
+    SemaphoreHandle_t panelIdle = panelIdleSem();
+    if (panelIdle)
+        xSemaphoreTake(panelIdle, portMAX_DELAY);
+    retainedFrame.magic = 0;
+    if (panelIdle)
+        xSemaphoreGive(panelIdle);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <Arduino.h>
+#include <GxEPD2_BW.h>
+
+// 1bpp frame geometry of the 1.54" panel (1 = white, MSB first, same layout as the controller RAM)
+#define EPD_FRAME_WIDTH 200
+#define EPD_FRAME_HEIGHT 200
+#define EPD_FRAME_STRIDE (EPD_FRAME_WIDTH / 8)
+#define EPD_FRAME_BYTES (EPD_FRAME_STRIDE * EPD_FRAME_HEIGHT)
+
+// Panel area to refresh (x and w are multiples of 8)
+struct EpdWindow
+{
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+};
+
+// Compare a rendered frame with the one retained from the previous push.
+// Returns false when the panel already shows this frame (nothing to refresh).
+bool epdFrameDiff(const uint8_t *frame, bool fullRefresh, EpdWindow &win);
+
+// Write the window of the frame to the controller, refresh it and retain the frame
+void epdFramePush(GxEPD2_154_D67 &epd, const uint8_t *frame, bool fullRefresh, const EpdWindow &win);
+
+// Same as epdFramePush, run by a background task so the caller can keep working while the
+// panel waveform runs. The frame must stay untouched and the panel unused until epdFrameJoin().
+// startUs (micros) is the start of the PERF_EPD_REFRESH measurement.
+void epdFramePushAsync(GxEPD2_154_D67 &epd, const uint8_t *frame, bool fullRefresh, const EpdWindow &win,
+                       uint32_t startUs);
+
+// Wait for a background push to finish (returns at once when none is running)
+void epdFrameJoin();
+
+// Let refreshes block on a BUSY edge interrupt instead of GxEPD2's 1 ms polling.
+// busyLevel is the level BUSY holds while the controller works. Safe to call again.
+void epdBusyWaitInstall(GxEPD2_154_D67 &epd, int8_t busyPin, uint8_t busyLevel);
+
+enum EpdCopyResult : uint8_t
+{
+    EPD_COPY_OK,
+    EPD_COPY_BUSY, // a push is replacing the frame right now; try again after it
+    EPD_COPY_NONE  // unknown (cold boot, power-off screen)
+};
+
+// Copy the last frame pushed to the panel (EPD_FRAME_BYTES) into out. Never waits for a
+// running push, so it is safe to call from other tasks (web server) at any time.
+EpdCopyResult epdFrameCopyRetained(uint8_t *out);
+
+// Forget the retained frame (panel content was drawn outside the frame renderer)
+void epdFrameInvalidate();
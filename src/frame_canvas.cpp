@@ -0,0 +1,252 @@
+#include "frame_canvas.h"
+
+// Fonts live in flash, which is memory-mapped on the ESP32: PROGMEM data is read directly.
+
+// n (1..32) bits of a packed glyph bitmap starting at bitOff, left-aligned
+static uint32_t readBits(const uint8_t *bitmap, uint32_t bitOff, uint8_t n)
+{
+    const uint8_t *p = bitmap + (bitOff >> 3);
+    const uint8_t skip = bitOff & 7;
+    const uint8_t bytes = (skip + n + 7) >> 3; // at most 5
+    uint64_t v = 0;
+    for (uint8_t i = 0; i < bytes; i++)
+        v |= (uint64_t)p[i] << (56 - 8 * i);
+    return (uint32_t)((v << skip) >> 32) & (0xFFFFFFFFUL << (32 - n));
+}
+
+void FrameCanvas::blitRow(int16_t x, int16_t y, uint32_t bits, uint8_t w, bool set)
+{
+    if (y < 0 || y >= height() || bits == 0)
+        return;
+    if (x < 0)
+    {
+        if (-x >= w)
+            return;
+        bits <<= -x;
+        w += x;
+        x = 0;
+    }
+    if (x >= width())
+        return;
+    if (x + w > width())
+    {
+        w = width() - x;
+        bits &= 0xFFFFFFFFUL << (32 - w);
+    }
+
+    uint8_t *dst = getBuffer() + y * ((WIDTH + 7) / 8) + (x >> 3);
+    const uint8_t shift = x & 7;
+    const uint64_t span = (uint64_t)bits << (32 - shift); // first pixel at bit 63 - shift
+    const uint8_t bytes = (shift + w + 7) >> 3;
+    for (uint8_t i = 0; i < bytes; i++)
+    {
+        const uint8_t m = (uint8_t)(span >> (56 - 8 * i));
+        if (set)
+            dst[i] |= m;
+        else
+            dst[i] &= ~m;
+    }
+}
+
+void FrameCanvas::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg,
+                           uint8_t size_x, uint8_t size_y)
+{
+    if (!gfxFont || size_x != 1 || size_y != 1 || getRotation() != 0)
+    {
+        GFXcanvas1::drawChar(x, y, c, color, bg, size_x, size_y);
+        return;
+    }
+
+    // write() only passes characters within first..last
+    const GFXglyph &glyph = gfxFont->glyph[c - gfxFont->first];
+    const uint8_t w = glyph.width;
+    const uint8_t h = glyph.height;
+    if (w == 0 || h == 0)
+        return;
+    if (w > 32)
+    {
+        GFXcanvas1::drawChar(x, y, c, color, bg, size_x, size_y);
+        return;
+    }
+
+    // Custom fonts are drawn transparently (bg ignored), as in Adafruit_GFX
+    const bool set = color != 0;
+    x += glyph.xOffset;
+    y += glyph.yOffset;
+
+    if (gfxFont == atlasFont_ && c >= atlasFirst_ && c <= atlasLast_)
+    {
+        const uint32_t *rows = &atlasRows_[atlasOffset_[c - atlasFirst_]];
+        for (uint8_t r = 0; r < h; r++)
+            blitRow(x, y + r, rows[r], w, set);
+        return;
+    }
+
+    uint32_t bitOff = (uint32_t)glyph.bitmapOffset * 8;
+    for (uint8_t r = 0; r < h; r++, bitOff += w)
+        blitRow(x, y + r, readBits(gfxFont->bitmap, bitOff, w), w, set);
+}
+
+bool FrameCanvas::setGlyphAtlas(const GFXfont *font, uint8_t first, uint8_t last)
+{
+    atlasFont_ = nullptr;
+    if (!font || first < font->first || last > font->last || last < first ||
+        (size_t)(last - first) >= sizeof(atlasOffset_) / sizeof(atlasOffset_[0]))
+        return false;
+
+    uint16_t used = 0;
+    for (uint16_t c = first; c <= last; c++)
+    {
+        const GFXglyph &glyph = font->glyph[c - font->first];
+        if (glyph.width > 32 || used + glyph.height > FRAME_ATLAS_ROWS)
+            return false;
+        atlasOffset_[c - first] = used;
+        uint32_t bitOff = (uint32_t)glyph.bitmapOffset * 8;
+        for (uint8_t r = 0; r < glyph.height; r++, bitOff += glyph.width)
+            atlasRows_[used++] = glyph.width ? readBits(font->bitmap, bitOff, glyph.width) : 0;
+    }
+
+    atlasFont_ = font;
+    atlasFirst_ = first;
+    atlasLast_ = last;
+    return true;
+}
+
+// ---------- Filled shapes ----------
+
+// Inclusive span x0..x1 on row y, clipped to the canvas
+void FrameCanvas::fillSpan(int16_t x0, int16_t x1, int16_t y, bool set)
+{
+    if (y < 0 || y >= height())
+        return;
+    if (x0 < 0)
+        x0 = 0;
+    if (x1 >= width())
+        x1 = width() - 1;
+    if (x1 < x0)
+        return;
+
+    uint8_t *row = getBuffer() + y * ((WIDTH + 7) / 8);
+    uint8_t *p = row + (x0 >> 3);
+    uint8_t *last = row + (x1 >> 3);
+    uint8_t head = 0xFF >> (x0 & 7);
+    const uint8_t tail = 0xFF << (7 - (x1 & 7));
+    if (p == last)
+        head &= tail;
+    *p = set ? (*p | head) : (*p & ~head);
+    if (p == last)
+        return;
+    if (last > p + 1)
+        memset(p + 1, set ? 0xFF : 0x00, last - p - 1);
+    *last = set ? (*last | tail) : (*last & ~tail);
+}
+
+void FrameCanvas::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    if (getRotation() != 0)
+    {
+        GFXcanvas1::fillRect(x, y, w, h, color);
+        return;
+    }
+    if (w <= 0 || h == 0)
+        return;
+    if (h < 0) // columns are drawn upwards from y, as GFXcanvas1::drawFastVLine does
+    {
+        h = -h;
+        y -= h - 1;
+    }
+    const int16_t y1 = (y + h > height()) ? height() : y + h;
+    for (int16_t row = (y < 0) ? 0 : y; row < y1; row++)
+        fillSpan(x, x + w - 1, row, color != 0);
+}
+
+const uint8_t *FrameCanvas::spanTable(int16_t r)
+{
+    for (uint8_t i = 0; i < FRAME_SPAN_SLOTS; i++)
+        if (spanRadius_[i] == r)
+            return spanHalfWidth_[i];
+
+    const uint8_t slot = spanNext_;
+    spanNext_ = (spanNext_ + 1) % FRAME_SPAN_SLOTS;
+    uint8_t *hw = spanHalfWidth_[slot];
+    memset(hw, 0, r + 1);
+
+    // Same midpoint walk as Adafruit_GFX::fillCircleHelper; each column it would draw
+    // (dx, rows -e..e) widens the spans of those rows instead
+    auto column = [hw](int16_t dx, int16_t e)
+    {
+        for (int16_t dy = 0; dy <= e; dy++)
+            if (hw[dy] < dx)
+                hw[dy] = dx;
+    };
+    int16_t f = 1 - r;
+    int16_t ddFx = 1;
+    int16_t ddFy = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+    int16_t px = x;
+    int16_t py = y;
+    while (x < y)
+    {
+        if (f >= 0)
+        {
+            y--;
+            ddFy += 2;
+            f += ddFy;
+        }
+        x++;
+        ddFx += 2;
+        f += ddFx;
+        if (x < y + 1)
+            column(x, y);
+        if (y != py)
+        {
+            column(py, px);
+            py = y;
+        }
+        px = x;
+    }
+
+    spanRadius_[slot] = r;
+    return hw;
+}
+
+void FrameCanvas::fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color)
+{
+    if (getRotation() != 0 || r < 0 || r > FRAME_SPAN_MAX_R)
+    {
+        GFXcanvas1::fillCircle(x0, y0, r, color);
+        return;
+    }
+    const uint8_t *hw = spanTable(r);
+    const bool set = color != 0;
+    fillSpan(x0 - hw[0], x0 + hw[0], y0, set);
+    for (int16_t dy = 1; dy <= r; dy++)
+    {
+        fillSpan(x0 - hw[dy], x0 + hw[dy], y0 - dy, set);
+        fillSpan(x0 - hw[dy], x0 + hw[dy], y0 + dy, set);
+    }
+}
+
+void FrameCanvas::fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color)
+{
+    const int16_t maxRadius = ((w < h) ? w : h) / 2;
+    if (r > maxRadius)
+        r = maxRadius;
+    if (getRotation() != 0 || w <= 0 || h <= 0 || r < 0 || r > FRAME_SPAN_MAX_R)
+    {
+        GFXcanvas1::fillRoundRect(x, y, w, h, r, color);
+        return;
+    }
+
+    // Corner circles are centered on x + r and x + w - r - 1; a zero half width leaves
+    // just the straight middle part
+    const uint8_t *hw = spanTable(r);
+    const bool set = color != 0;
+    for (int16_t dy = r; dy >= 1; dy--)
+        fillSpan(x + r - hw[dy], x + w - r - 1 + hw[dy], y + r - dy, set);
+    for (int16_t row = y + r; row < y + h - r; row++)
+        fillSpan(x, x + w - 1, row, set);
+    for (int16_t dy = 1; dy <= r; dy++)
+        fillSpan(x + r - hw[dy], x + w - r - 1 + hw[dy], y + h - 1 - r + dy, set);
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+// GFXcanvas1 with a row-based text path: each glyph row is written into the 1bpp buffer
+// with one shift and a few byte masks instead of one drawPixel() per set bit.
+// Custom fonts at text size 1, rotation 0 and glyphs up to 32 px wide take the fast
+// path (all fonts in fonts.h); anything else falls back to Adafruit_GFX.
+// Filled shapes are written as horizontal spans (masked edge bytes, memset in between)
+// with the same pixels as the Adafruit_GFX versions.
+
+#define FRAME_ATLAS_ROWS 512 // pre-expanded glyph rows (4 bytes each)
+#define FRAME_SPAN_SLOTS 4   // cached circle/corner span tables (one per radius)
+#define FRAME_SPAN_MAX_R 63  // larger radii fall back to Adafruit_GFX
+
+class FrameCanvas : public GFXcanvas1
+{
+public:
+    FrameCanvas(uint16_t w, uint16_t h) : GFXcanvas1(w, h) {}
+
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg,
+                  uint8_t size_x, uint8_t size_y) override;
+
+    // Expand glyphs first..last of font into left-aligned 32-bit rows, so drawing them skips
+    // the bit-stream unpacking (the large clock digits). One font at a time; false if it does not fit.
+    bool setGlyphAtlas(const GFXfont *font, uint8_t first, uint8_t last);
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    // Adafruit_GFX declares these non-virtual: the fast versions apply to calls made on a FrameCanvas
+    void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+    void fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color);
+
+private:
+    void blitRow(int16_t x, int16_t y, uint32_t bits, uint8_t w, bool set);
+    void fillSpan(int16_t x0, int16_t x1, int16_t y, bool set);
+    const uint8_t *spanTable(int16_t r);
+
+    const GFXfont *atlasFont_ = nullptr;
+    uint8_t atlasFirst_ = 0;
+    uint8_t atlasLast_ = 0;
+    uint16_t atlasOffset_[96] = {};
+    uint32_t atlasRows_[FRAME_ATLAS_ROWS] = {};
+
+    // Half width of a radius-r circle on each row 0..r away from its center
+    int16_t spanRadius_[FRAME_SPAN_SLOTS] = {-1, -1, -1, -1};
+    uint8_t spanHalfWidth_[FRAME_SPAN_SLOTS][FRAME_SPAN_MAX_R + 1] = {};
+    uint8_t spanNext_ = 0;
+};
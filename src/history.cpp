@@ -0,0 +1,634 @@
+#include "history.h"
+#include "config.h"
+#include <LittleFS.h>
+#include <mutex>
+
+#define HISTORY_MAGIC 0x4853 // "HS"
+#define HISTORY_RTC_CAPACITY 32
+#define HISTORY_HEAD_MAGIC 0x48454144UL
+
+struct HistoryBlockHeader
+{
+    uint16_t magic;
+    uint16_t reserved;
+    uint32_t baseEpoch; // timestamp of the first record
+};
+
+struct HistoryRecord
+{
+    uint16_t dtSec; // seconds since the block base timestamp
+    int16_t tempCenti;
+    uint16_t humCenti;
+    uint16_t batteryMv;
+};
+
+static_assert(sizeof(HistoryBlockHeader) == 8, "unexpected history header size");
+static_assert(sizeof(HistoryRecord) == 8, "unexpected history record size");
+
+#define HISTORY_RECORDS_PER_BLOCK ((HISTORY_BLOCK_SIZE - sizeof(HistoryBlockHeader)) / sizeof(HistoryRecord))
+
+struct PendingSample
+{
+    uint32_t epoch;
+    int16_t tempCenti;
+    uint16_t humCenti;
+    uint16_t batteryMv;
+};
+
+// Block file currently being filled (cached across deep sleep to avoid listing the directory)
+struct HistoryHead
+{
+    uint32_t magic;
+    uint32_t seq; // 0 = no block yet
+    uint32_t baseEpoch;
+    uint16_t count;
+};
+
+// Sparse time index: one entry per block file in slot seq % HISTORY_BLOCKS (seq 0 = unused)
+struct HistoryIndexEntry
+{
+    uint32_t seq;
+    uint32_t baseEpoch;
+    uint16_t count;
+};
+
+static RTC_DATA_ATTR PendingSample pending[HISTORY_RTC_CAPACITY];
+static RTC_DATA_ATTR uint8_t pendingCount = 0;
+static RTC_DATA_ATTR HistoryHead head;
+static HistoryIndexEntry blockIndex[HISTORY_BLOCKS];
+static bool blockIndexValid = false;
+// Block files below this sequence have been deleted since boot (exports stop reading them)
+static uint32_t firstLiveSeq = 0;
+static std::mutex historyMutex;
+
+static int16_t toCenti(float v, float lo, float hi)
+{
+    if (v < lo)
+        v = lo;
+    if (v > hi)
+        v = hi;
+    return (int16_t)lroundf(v * 100.0f);
+}
+
+void historyAppend(uint32_t epoch, float tempC, float humidityPct, int batteryMv)
+{
+    if (epoch < HISTORY_MIN_EPOCH)
+        return;
+
+    std::lock_guard<std::mutex> lk(historyMutex);
+    if (pendingCount >= HISTORY_RTC_CAPACITY)
+    {
+        // Flash unavailable for a while: keep the newest readings
+        memmove(&pending[0], &pending[1], sizeof(PendingSample) * (HISTORY_RTC_CAPACITY - 1));
+        pendingCount = HISTORY_RTC_CAPACITY - 1;
+    }
+
+    PendingSample &s = pending[pendingCount++];
+    s.epoch = epoch;
+    s.tempCenti = toCenti(tempC, -300.0f, 300.0f);
+    s.humCenti = (uint16_t)toCenti(humidityPct, 0.0f, 100.0f);
+    s.batteryMv = (uint16_t)constrain(batteryMv, 0, 65535);
+}
+
+uint32_t historyPendingCount()
+{
+    return pendingCount;
+}
+
+static void blockPath(char *out, size_t cap, uint32_t seq)
+{
+    snprintf(out, cap, HISTORY_DIR "/%lu.bin", (unsigned long)seq);
+}
+
+// Sequence number from a directory entry name ("<seq>.bin", with or without the directory), 0 if not a block
+static uint32_t blockSeqFromName(const char *name)
+{
+    const char *base = strrchr(name, '/');
+    base = base ? base + 1 : name;
+    char *end;
+    const unsigned long seq = strtoul(base, &end, 10);
+    return (end != base && strcmp(end, ".bin") == 0) ? (uint32_t)seq : 0;
+}
+
+// Header and record count of one block file; false if it is missing or not a history block
+static bool readBlockInfo(uint32_t seq, HistoryIndexEntry &out)
+{
+    char path[32];
+    blockPath(path, sizeof(path), seq);
+    File f = LittleFS.open(path, "r");
+    if (!f)
+        return false;
+    HistoryBlockHeader hdr;
+    const size_t size = f.size();
+    const bool ok = f.read((uint8_t *)&hdr, sizeof(hdr)) == sizeof(hdr) && hdr.magic == HISTORY_MAGIC;
+    f.close();
+    if (!ok)
+        return false;
+    out = {seq, hdr.baseEpoch, (uint16_t)((size - sizeof(hdr)) / sizeof(HistoryRecord))};
+    return true;
+}
+
+// List the block files into the index and derive the head from the newest one.
+// Files older than the ring (left by an interrupted rotation) are deleted.
+static void scanBlocks()
+{
+    memset(blockIndex, 0, sizeof(blockIndex));
+    head = {};
+    uint32_t seqs[HISTORY_BLOCKS + 8];
+    size_t n = 0;
+    File dir = LittleFS.open(HISTORY_DIR);
+    for (File entry = dir ? dir.openNextFile() : File(); entry; entry = dir.openNextFile())
+    {
+        const uint32_t seq = blockSeqFromName(entry.name());
+        entry.close();
+        if (seq == 0)
+            continue;
+        if (n < sizeof(seqs) / sizeof(seqs[0]))
+            seqs[n++] = seq;
+        if (seq > head.seq)
+            head.seq = seq;
+    }
+    dir.close();
+
+    firstLiveSeq = (head.seq > HISTORY_BLOCKS) ? head.seq - HISTORY_BLOCKS + 1 : 1;
+    for (size_t i = 0; i < n; i++)
+    {
+        HistoryIndexEntry entry;
+        if (seqs[i] < firstLiveSeq)
+        {
+            char path[32];
+            blockPath(path, sizeof(path), seqs[i]);
+            LittleFS.remove(path);
+        }
+        else if (readBlockInfo(seqs[i], entry))
+        {
+            blockIndex[seqs[i] % HISTORY_BLOCKS] = entry;
+        }
+    }
+    blockIndexValid = true;
+
+    const HistoryIndexEntry &newest = blockIndex[head.seq % HISTORY_BLOCKS];
+    if (head.seq != 0 && newest.seq == head.seq)
+    {
+        head.baseEpoch = newest.baseEpoch;
+        head.count = newest.count;
+    }
+    else if (head.seq != 0)
+    {
+        // Newest file unreadable (no header): the next reading starts a new block
+        head.count = HISTORY_RECORDS_PER_BLOCK;
+    }
+    head.magic = HISTORY_HEAD_MAGIC;
+    DEBUG_PRINTF("[HIST] Head: seq %lu, %u records, %u block files\n",
+                 (unsigned long)head.seq, head.count, (unsigned)n);
+}
+
+// Create the next block file with its header, deleting the one that falls out of the ring
+static bool startBlock(File &f, uint32_t baseEpoch)
+{
+    const uint32_t seq = head.seq + 1;
+    if (seq > HISTORY_BLOCKS)
+    {
+        char oldPath[32];
+        blockPath(oldPath, sizeof(oldPath), seq - HISTORY_BLOCKS);
+        firstLiveSeq = seq - HISTORY_BLOCKS + 1;
+        if (LittleFS.exists(oldPath))
+            LittleFS.remove(oldPath);
+        if (blockIndexValid)
+            blockIndex[seq % HISTORY_BLOCKS] = {};
+    }
+
+    char path[32];
+    blockPath(path, sizeof(path), seq);
+    f = LittleFS.open(path, "w");
+    const HistoryBlockHeader hdr = {HISTORY_MAGIC, 0, baseEpoch};
+    if (!f || f.write((const uint8_t *)&hdr, sizeof(hdr)) != sizeof(hdr))
+        return false;
+    head.seq = seq;
+    head.baseEpoch = baseEpoch;
+    head.count = 0;
+    return true;
+}
+
+bool historyFlush(bool force)
+{
+    std::lock_guard<std::mutex> lk(historyMutex);
+    if (pendingCount == 0 || (!force && pendingCount < HISTORY_FLUSH_EVERY))
+        return true;
+
+    if (!LittleFS.begin(false))
+    {
+        DEBUG_PRINT("[HIST][ERR] LittleFS mount failed, keeping readings in RTC memory.");
+        return false;
+    }
+
+    if (head.magic != HISTORY_HEAD_MAGIC)
+    {
+        if (LittleFS.exists(HISTORY_LEGACY_PATH))
+        {
+            DEBUG_PRINT("[HIST] Removing the single-file history of earlier firmware.");
+            LittleFS.remove(HISTORY_LEGACY_PATH);
+        }
+        if (!LittleFS.exists(HISTORY_DIR) && !LittleFS.mkdir(HISTORY_DIR))
+        {
+            DEBUG_PRINT("[HIST][ERR] Cannot create the history directory.");
+            return false;
+        }
+        scanBlocks();
+    }
+
+    bool ok = true;
+    File f;
+    for (uint8_t i = 0; i < pendingCount && ok; i++)
+    {
+        const PendingSample &s = pending[i];
+        const bool needNewBlock = head.seq == 0 ||
+                                  head.count >= HISTORY_RECORDS_PER_BLOCK ||
+                                  s.epoch < head.baseEpoch ||
+                                  s.epoch - head.baseEpoch > UINT16_MAX;
+        if (needNewBlock)
+        {
+            if (f)
+                f.close();
+            ok = startBlock(f, s.epoch);
+        }
+        else if (!f)
+        {
+            char path[32];
+            blockPath(path, sizeof(path), head.seq);
+            f = LittleFS.open(path, "a");
+            ok = (bool)f;
+        }
+
+        HistoryRecord rec = {(uint16_t)(s.epoch - head.baseEpoch), s.tempCenti, s.humCenti, s.batteryMv};
+        ok = ok && f.write((const uint8_t *)&rec, sizeof(rec)) == sizeof(rec);
+        if (ok)
+        {
+            head.count++;
+            if (blockIndexValid)
+                blockIndex[head.seq % HISTORY_BLOCKS] = {head.seq, head.baseEpoch, head.count};
+        }
+    }
+    if (f)
+        f.close();
+
+    if (!ok)
+    {
+        // Head may not match the files anymore: list them again on the next flush
+        head.magic = 0;
+        blockIndexValid = false;
+        DEBUG_PRINT("[HIST][ERR] History write failed.");
+        return false;
+    }
+
+    DEBUG_PRINTF("[HIST] Flushed %u readings (block %lu, %u records)\n",
+                 pendingCount, (unsigned long)head.seq, head.count);
+    pendingCount = 0;
+    return true;
+}
+
+// ---------- Range export ----------
+
+#define HISTORY_EXPORT_BATCH 32
+
+struct HistoryExport
+{
+    uint32_t from;
+    uint32_t to;
+    uint32_t step;
+    HistoryFormat format;
+    File file; // block being read
+
+    // Blocks overlapping the range, oldest first (snapshot of the index at export start)
+    HistoryIndexEntry blocks[HISTORY_BLOCKS];
+    uint8_t blockCount;
+    uint8_t blockPos;
+    bool inBlock;
+    HistoryIndexEntry cur;
+    uint16_t recPos;
+    HistoryRecord cache[HISTORY_EXPORT_BATCH];
+    uint8_t cacheLen;
+    uint8_t cachePos;
+
+    // Readings still queued in RTC memory, emitted after the files
+    PendingSample tail[HISTORY_RTC_CAPACITY];
+    uint8_t tailCount;
+    uint8_t tailPos;
+    bool finished;
+
+    // Downsampling bucket (step > 0)
+    bool bucketOpen;
+    uint32_t bucketStart;
+    uint32_t bucketN;
+    int32_t minV[3], maxV[3];
+    int64_t sumV[3];
+
+    enum Stage : uint8_t
+    {
+        STAGE_HEADER,
+        STAGE_ROWS,
+        STAGE_FOOTER,
+        STAGE_DONE
+    } stage;
+    uint32_t rows;
+    char line[192];
+    size_t lineLen;
+    size_t linePos;
+};
+
+HistoryExport *historyExportBegin(uint32_t from, uint32_t to, uint32_t step, HistoryFormat format)
+{
+    HistoryExport *e = new (std::nothrow) HistoryExport();
+    if (!e)
+        return nullptr;
+    e->from = from;
+    e->to = to;
+    e->step = step;
+    e->format = format;
+    e->stage = HistoryExport::STAGE_HEADER;
+
+    std::lock_guard<std::mutex> lk(historyMutex);
+    if (!blockIndexValid && LittleFS.exists(HISTORY_DIR))
+        scanBlocks();
+
+    // Order used blocks by sequence (insertion sort, at most HISTORY_BLOCKS entries)
+    for (uint16_t b = 0; b < HISTORY_BLOCKS && blockIndexValid; b++)
+    {
+        const HistoryIndexEntry &entry = blockIndex[b];
+        if (entry.seq == 0 || entry.count == 0)
+            continue;
+        int i = e->blockCount++;
+        while (i > 0 && e->blocks[i - 1].seq > entry.seq)
+        {
+            e->blocks[i] = e->blocks[i - 1];
+            i--;
+        }
+        e->blocks[i] = entry;
+    }
+
+    memcpy(e->tail, pending, sizeof(PendingSample) * pendingCount);
+    e->tailCount = pendingCount;
+    return e;
+}
+
+void historyExportEnd(HistoryExport *e)
+{
+    if (!e)
+        return;
+    if (e->file)
+    {
+        std::lock_guard<std::mutex> lk(historyMutex);
+        e->file.close();
+    }
+    delete e;
+}
+
+// Open the next block file that can hold readings in [from, to] using the sparse index
+static bool enterNextBlock(HistoryExport *e)
+{
+    while (e->blockPos < e->blockCount)
+    {
+        const HistoryIndexEntry &b = e->blocks[e->blockPos++];
+        const uint32_t nextBase = (e->blockPos < e->blockCount) ? e->blocks[e->blockPos].baseEpoch : UINT32_MAX;
+        if (nextBase < e->from)
+            continue;
+        if (b.baseEpoch > e->to)
+        {
+            e->blockPos = e->blockCount;
+            return false;
+        }
+
+        // Skip blocks deleted by the ring since the export started
+        std::lock_guard<std::mutex> lk(historyMutex);
+        if (b.seq < firstLiveSeq)
+            continue;
+        char path[32];
+        blockPath(path, sizeof(path), b.seq);
+        e->file = LittleFS.open(path, "r");
+        if (!e->file)
+            continue;
+
+        e->cur = b;
+        e->recPos = 0;
+        e->cacheLen = e->cachePos = 0;
+        e->inBlock = true;
+        return true;
+    }
+    return false;
+}
+
+static bool nextFileSample(HistoryExport *e, PendingSample &out)
+{
+    for (;;)
+    {
+        if (e->cachePos < e->cacheLen)
+        {
+            const HistoryRecord &r = e->cache[e->cachePos++];
+            out = {e->cur.baseEpoch + r.dtSec, r.tempCenti, r.humCenti, r.batteryMv};
+            return true;
+        }
+        if (e->inBlock && e->recPos < e->cur.count)
+        {
+            const uint16_t n = (uint16_t)min<int>(HISTORY_EXPORT_BATCH, e->cur.count - e->recPos);
+            std::lock_guard<std::mutex> lk(historyMutex);
+            size_t got = 0;
+            // The file may have been deleted by a flush since it was opened
+            if (e->cur.seq >= firstLiveSeq &&
+                e->file.seek(sizeof(HistoryBlockHeader) + e->recPos * sizeof(HistoryRecord), SeekSet))
+                got = e->file.read((uint8_t *)e->cache, n * sizeof(HistoryRecord)) / sizeof(HistoryRecord);
+            e->recPos = (got == n) ? e->recPos + n : e->cur.count;
+            e->cacheLen = (uint8_t)got;
+            e->cachePos = 0;
+            continue;
+        }
+        if (e->inBlock)
+        {
+            std::lock_guard<std::mutex> lk(historyMutex);
+            e->file.close();
+            e->inBlock = false;
+        }
+        if (!enterNextBlock(e))
+            return false;
+    }
+}
+
+// Next reading inside [from, to], file first then the RTC queue
+static bool nextSample(HistoryExport *e, PendingSample &out)
+{
+    while (!e->finished)
+    {
+        bool have = nextFileSample(e, out);
+        if (!have && e->tailPos < e->tailCount)
+        {
+            out = e->tail[e->tailPos++];
+            have = true;
+        }
+        if (!have)
+            break;
+        if (out.epoch < e->from)
+            continue;
+        if (out.epoch > e->to)
+            break;
+        return true;
+    }
+    e->finished = true;
+    return false;
+}
+
+static int formatCenti(char *out, size_t cap, int32_t v)
+{
+    const uint32_t a = (v < 0) ? (uint32_t)(-v) : (uint32_t)v;
+    return snprintf(out, cap, "%s%lu.%02lu", v < 0 ? "-" : "", (unsigned long)(a / 100), (unsigned long)(a % 100));
+}
+
+static void formatRaw(HistoryExport *e, const PendingSample &s)
+{
+    char t[12], h[12];
+    formatCenti(t, sizeof(t), s.tempCenti);
+    formatCenti(h, sizeof(h), s.humCenti);
+    if (e->format == HISTORY_CSV)
+        e->lineLen = snprintf(e->line, sizeof(e->line), "%lu,%s,%s,%u\n",
+                              (unsigned long)s.epoch, t, h, s.batteryMv);
+    else
+        e->lineLen = snprintf(e->line, sizeof(e->line), "%s{\"t\":%lu,\"temp\":%s,\"hum\":%s,\"batt\":%u}",
+                              e->rows ? "," : "", (unsigned long)s.epoch, t, h, s.batteryMv);
+}
+
+static void bucketBegin(HistoryExport *e, const PendingSample &s)
+{
+    const int32_t v[3] = {s.tempCenti, s.humCenti, s.batteryMv};
+    e->bucketOpen = true;
+    e->bucketStart = s.epoch - (s.epoch % e->step);
+    e->bucketN = 1;
+    for (int i = 0; i < 3; i++)
+    {
+        e->minV[i] = e->maxV[i] = v[i];
+        e->sumV[i] = v[i];
+    }
+}
+
+static void bucketAdd(HistoryExport *e, const PendingSample &s)
+{
+    const int32_t v[3] = {s.tempCenti, s.humCenti, s.batteryMv};
+    e->bucketN++;
+    for (int i = 0; i < 3; i++)
+    {
+        if (v[i] < e->minV[i])
+            e->minV[i] = v[i];
+        if (v[i] > e->maxV[i])
+            e->maxV[i] = v[i];
+        e->sumV[i] += v[i];
+    }
+}
+
+static void formatBucket(HistoryExport *e)
+{
+    // min/avg/max for temperature and humidity (centi units), then battery (mV)
+    char f[6][12];
+    for (int i = 0; i < 2; i++)
+    {
+        formatCenti(f[i * 3], sizeof(f[0]), e->minV[i]);
+        formatCenti(f[i * 3 + 1], sizeof(f[0]), (int32_t)(e->sumV[i] / (int64_t)e->bucketN));
+        formatCenti(f[i * 3 + 2], sizeof(f[0]), e->maxV[i]);
+    }
+    const long bAvg = (long)(e->sumV[2] / (int64_t)e->bucketN);
+    if (e->format == HISTORY_CSV)
+        e->lineLen = snprintf(e->line, sizeof(e->line), "%lu,%lu,%s,%s,%s,%s,%s,%s,%ld,%ld,%ld\n",
+                              (unsigned long)e->bucketStart, (unsigned long)e->bucketN,
+                              f[0], f[1], f[2], f[3], f[4], f[5],
+                              (long)e->minV[2], bAvg, (long)e->maxV[2]);
+    else
+        e->lineLen = snprintf(e->line, sizeof(e->line),
+                              "%s{\"t\":%lu,\"n\":%lu,\"temp\":[%s,%s,%s],\"hum\":[%s,%s,%s],\"batt\":[%ld,%ld,%ld]}",
+                              e->rows ? "," : "", (unsigned long)e->bucketStart, (unsigned long)e->bucketN,
+                              f[0], f[1], f[2], f[3], f[4], f[5],
+                              (long)e->minV[2], bAvg, (long)e->maxV[2]);
+}
+
+static bool nextRow(HistoryExport *e)
+{
+    PendingSample s;
+    if (e->step == 0)
+    {
+        if (!nextSample(e, s))
+            return false;
+        formatRaw(e, s);
+        return true;
+    }
+
+    while (nextSample(e, s))
+    {
+        if (!e->bucketOpen)
+        {
+            bucketBegin(e, s);
+            continue;
+        }
+        if (s.epoch - (s.epoch % e->step) == e->bucketStart)
+        {
+            bucketAdd(e, s);
+            continue;
+        }
+        formatBucket(e);
+        bucketBegin(e, s);
+        return true;
+    }
+    if (!e->bucketOpen)
+        return false;
+    formatBucket(e);
+    e->bucketOpen = false;
+    return true;
+}
+
+// Produce the next piece of output into e->line; false once everything was emitted
+static bool fillLine(HistoryExport *e)
+{
+    e->lineLen = 0;
+    e->linePos = 0;
+    switch (e->stage)
+    {
+    case HistoryExport::STAGE_HEADER:
+        if (e->format == HISTORY_CSV)
+            e->lineLen = snprintf(e->line, sizeof(e->line), "%s\n",
+                                  e->step ? "epoch,n,temp_min,temp_avg,temp_max,hum_min,hum_avg,hum_max,batt_min,batt_avg,batt_max"
+                                          : "epoch,temp_c,humidity_pct,battery_mv");
+        else
+            e->lineLen = snprintf(e->line, sizeof(e->line), "{\"ok\":true,\"from\":%lu,\"to\":%lu,\"step\":%lu,\"points\":[",
+                                  (unsigned long)e->from, (unsigned long)e->to, (unsigned long)e->step);
+        e->stage = HistoryExport::STAGE_ROWS;
+        return true;
+    case HistoryExport::STAGE_ROWS:
+        if (nextRow(e))
+        {
+            e->rows++;
+            return true;
+        }
+        e->stage = HistoryExport::STAGE_FOOTER;
+        return fillLine(e);
+    case HistoryExport::STAGE_FOOTER:
+        if (e->format == HISTORY_JSON)
+            e->lineLen = snprintf(e->line, sizeof(e->line), "]}");
+        e->stage = HistoryExport::STAGE_DONE;
+        return true;
+    default:
+        return false;
+    }
+}
+
+size_t historyExportRead(HistoryExport *e, uint8_t *buf, size_t maxLen)
+{
+    size_t out = 0;
+    while (out < maxLen)
+    {
+        if (e->linePos < e->lineLen)
+        {
+            const size_t n = min(maxLen - out, e->lineLen - e->linePos);
+            memcpy(buf + out, e->line + e->linePos, n);
+            out += n;
+            e->linePos += n;
+            continue;
+        }
+        if (!fillLine(e))
+            break;
+    }
+    return out;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <Arduino.h>
+
+// On-device measurement history.
+// Readings are queued in RTC memory and written in batches to LittleFS as a ring of
+// HISTORY_BLOCKS small files, /hist/<seq>.bin, one per flash block. Each file starts with a
+// header (base timestamp) written once at creation, followed by fixed 8-byte records whose
+// timestamps are seconds since the base. Files are only ever appended to; the record count
+// follows from the file size and the ring head from the file names, and the oldest file is
+// deleted when a new one would exceed HISTORY_BLOCKS.
+
+#define HISTORY_DIR "/hist"
+#define HISTORY_LEGACY_PATH "/history.bin" // single-file ring of earlier firmware, removed
+#define HISTORY_BLOCK_SIZE 4096
+#define HISTORY_BLOCKS 96     // 384 KB, ~34 days at one reading per minute
+#define HISTORY_FLUSH_EVERY 15 // queued readings per flash write
+#define HISTORY_MIN_EPOCH 1600000000UL // readings before NTP time are not stored
+
+// Queue one reading (RTC memory only, no flash access)
+void historyAppend(uint32_t epoch, float tempC, float humidityPct, int batteryMv);
+
+// Write queued readings once HISTORY_FLUSH_EVERY are pending, or whatever is queued when force is set
+bool historyFlush(bool force);
+
+uint32_t historyPendingCount();
+
+// Streaming range export for chunked HTTP responses.
+// step = 0 emits every reading; step > 0 emits min/avg/max per step-second bucket.
+enum HistoryFormat : uint8_t
+{
+    HISTORY_JSON,
+    HISTORY_CSV
+};
+
+struct HistoryExport;
+
+HistoryExport *historyExportBegin(uint32_t from, uint32_t to, uint32_t step, HistoryFormat format);
+// Fill buf with the next part of the output; returns 0 once the export is complete
+size_t historyExportRead(HistoryExport *e, uint8_t *buf, size_t maxLen);
+void historyExportEnd(HistoryExport *e);
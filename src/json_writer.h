@@ -0,0 +1,167 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Allocation-free JSON output into a caller-provided buffer.
+// Keys are literals with quotes and colon baked in at compile time (JSON_KEY), numbers
+// are fixed point integers, so nothing is parsed or converted through float at runtime.
+// Output is always NUL-terminated; on overflow it is truncated and ok() turns false.
+
+struct JsonKey
+{
+    const char *text; // "\"name\":"
+    uint8_t len;
+};
+
+#define JSON_KEY(name) {"\"" name "\":", sizeof("\"" name "\":") - 1}
+#define JSON_NO_KEY {nullptr, 0}
+
+namespace jsonw
+{
+    template <uint8_t Decimals>
+    struct Pow10
+    {
+        static const uint32_t value = 10 * Pow10<Decimals - 1>::value;
+    };
+
+    template <>
+    struct Pow10<0>
+    {
+        static const uint32_t value = 1;
+    };
+}
+
+class JsonWriter
+{
+public:
+    JsonWriter(char *out, size_t cap) : out_(out), cap_(cap)
+    {
+        if (cap_ > 0)
+            out_[0] = '\0';
+    }
+
+    size_t length() const { return len_; }
+    bool ok() const { return !overflow_; }
+
+    void beginObject()
+    {
+        put('{');
+        first_ = true;
+    }
+
+    void endObject()
+    {
+        put('}');
+        first_ = false;
+    }
+
+    // Verbatim text (already valid JSON), length known at compile time
+    template <size_t N>
+    void raw(const char (&s)[N]) { put(s, N - 1); }
+    void raw(const char *s, size_t n) { put(s, n); }
+
+    void key(const JsonKey &k)
+    {
+        if (!first_)
+            put(',');
+        first_ = false;
+        put(k.text, k.len);
+    }
+
+    void u32(uint32_t v)
+    {
+        char digits[10];
+        const size_t n = uintDigits(digits + sizeof(digits), v, 1);
+        put(digits + sizeof(digits) - n, n);
+    }
+
+    void i32(int32_t v)
+    {
+        if (v < 0)
+            put('-');
+        u32(v < 0 ? (uint32_t)0 - (uint32_t)v : (uint32_t)v);
+    }
+
+    // scaled / 10^Decimals, e.g. fixed<2>(-512) -> -5.12
+    template <uint8_t Decimals>
+    void fixed(int32_t scaled)
+    {
+        const uint32_t scale = jsonw::Pow10<Decimals>::value;
+        const uint32_t mag = (scaled < 0) ? (uint32_t)0 - (uint32_t)scaled : (uint32_t)scaled;
+        if (scaled < 0)
+            put('-');
+        u32(mag / scale);
+        if (Decimals > 0)
+        {
+            char digits[10];
+            const size_t n = uintDigits(digits + sizeof(digits), mag % scale, Decimals);
+            put('.');
+            put(digits + sizeof(digits) - n, n);
+        }
+    }
+
+    // Quoted string with the characters JSON requires escaped
+    void str(const char *s)
+    {
+        put('"');
+        for (; s && *s; s++)
+        {
+            const unsigned char c = (unsigned char)*s;
+            if (c == '"' || c == '\\')
+            {
+                put('\\');
+                put((char)c);
+            }
+            else if (c < 0x20)
+            {
+                static const char hex[] = "0123456789abcdef";
+                const char esc[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 15]};
+                put(esc, sizeof(esc));
+            }
+            else
+                put((char)c);
+        }
+        put('"');
+    }
+
+private:
+    // Writes digits right-aligned ending at end, returns their count
+    static size_t uintDigits(char *end, uint32_t v, uint8_t minDigits)
+    {
+        size_t n = 0;
+        do
+        {
+            *--end = (char)('0' + v % 10);
+            v /= 10;
+            n++;
+        } while (v != 0 || n < minDigits);
+        return n;
+    }
+
+    void put(char c) { put(&c, 1); }
+
+    void put(const char *s, size_t n)
+    {
+        if (cap_ == 0)
+        {
+            overflow_ = overflow_ || n > 0;
+            return;
+        }
+        const size_t room = cap_ - 1 - len_;
+        if (n > room)
+        {
+            n = room;
+            overflow_ = true;
+        }
+        memcpy(out_ + len_, s, n);
+        len_ += n;
+        out_[len_] = '\0';
+    }
+
+    char *out_;
+    size_t cap_;
+    size_t len_ = 0;
+    bool first_ = true;
+    bool overflow_ = false;
+};
@@ -0,0 +1,433 @@
+#include "log_ring.h"
+#include <atomic>
+#include <soc/soc_memory_layout.h>
+
+using namespace logring;
+
+static_assert((LOG_ARENA_SIZE & (LOG_ARENA_SIZE - 1)) == 0, "LOG_ARENA_SIZE must be a power of two");
+
+#define LOG_MASK (LOG_ARENA_SIZE - 1)
+
+static uint8_t arena[LOG_ARENA_SIZE] __attribute__((aligned(8)));
+static std::atomic<uint32_t> writeHead{0};
+
+static inline Header *headerAt(uint32_t pos)
+{
+    return reinterpret_cast<Header *>(arena + (pos & LOG_MASK));
+}
+
+uint8_t *logring::reserve(uint32_t len, uint32_t &pos)
+{
+    uint32_t head = writeHead.load(std::memory_order_relaxed);
+    uint32_t start;
+    do
+    {
+        // Records never wrap: skip to the arena start when the tail is too short
+        const uint32_t off = head & LOG_MASK;
+        start = (off + len > LOG_ARENA_SIZE) ? head + (LOG_ARENA_SIZE - off) : head;
+    } while (!writeHead.compare_exchange_weak(head, start + len, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    if (start != head)
+    {
+        Header *pad = headerAt(head);
+        pad->len = (uint16_t)(start - head);
+        pad->kind = KIND_PAD;
+        pad->nargs = 0;
+        __atomic_store_n(&pad->pos, head, __ATOMIC_RELEASE);
+    }
+    pos = start;
+    return arena + (start & LOG_MASK);
+}
+
+void logring::commit(uint8_t *rec, uint32_t pos, uint32_t len, RecordKind kind, uint8_t nargs, const char *fmt)
+{
+    Header *h = reinterpret_cast<Header *>(rec);
+    h->len = (uint16_t)len;
+    h->kind = kind;
+    h->nargs = nargs;
+    h->ms = millis();
+    h->fmt = fmt;
+    __atomic_store_n(&h->pos, pos, __ATOMIC_RELEASE);
+}
+
+void logPrint(const char *msg)
+{
+    if (!msg)
+        return;
+    if (esp_ptr_in_drom(msg))
+    {
+        uint32_t pos;
+        uint8_t *rec = reserve(sizeof(Header), pos);
+        commit(rec, pos, sizeof(Header), KIND_RAW, 0, msg);
+    }
+    else
+    {
+        logPrintf("%s", msg);
+    }
+}
+
+uint32_t logHead()
+{
+    return writeHead.load(std::memory_order_acquire);
+}
+
+// Oldest record still intact: record starts are the only words holding their own position
+static uint32_t resync(uint32_t head)
+{
+    for (uint32_t p = (head - LOG_ARENA_SIZE + 7) & ~7u; (int32_t)(head - p) > 0; p += 8)
+    {
+        const Header *h = headerAt(p);
+        if (__atomic_load_n(&h->pos, __ATOMIC_ACQUIRE) != p)
+            continue;
+        if ((h->kind == KIND_PAD || h->kind == KIND_FMT || h->kind == KIND_RAW) &&
+            h->len >= 8 && (h->len & 7) == 0 && h->len <= LOG_MAX_RECORD + 8)
+            return p;
+    }
+    return head;
+}
+
+struct DecodedArg
+{
+    uint8_t tag;
+    uint8_t len;
+    union
+    {
+        int64_t i;
+        double d;
+        const char *s;
+    };
+};
+
+static size_t decodeArgs(const uint8_t *p, const uint8_t *end, uint8_t nargs, DecodedArg *args)
+{
+    size_t n = 0;
+    while (n < nargs && p < end)
+    {
+        DecodedArg &a = args[n];
+        a.tag = *p++;
+        switch (a.tag)
+        {
+        case ARG_I32:
+        {
+            int32_t v;
+            memcpy(&v, p, 4);
+            a.i = v;
+            p += 4;
+            break;
+        }
+        case ARG_U32:
+        case ARG_PTR:
+        {
+            uint32_t v;
+            memcpy(&v, p, 4);
+            a.i = v;
+            p += 4;
+            break;
+        }
+        case ARG_I64:
+        case ARG_U64:
+            memcpy(&a.i, p, 8);
+            p += 8;
+            break;
+        case ARG_F64:
+            memcpy(&a.d, p, 8);
+            p += 8;
+            break;
+        case ARG_STR:
+            a.len = *p++;
+            a.s = (const char *)p;
+            p += a.len;
+            break;
+        default:
+            return n;
+        }
+        n++;
+    }
+    return n;
+}
+
+static size_t appendStr(char *out, size_t cap, size_t len, const char *s, size_t n)
+{
+    if (len + n >= cap)
+        n = (len + 1 < cap) ? cap - len - 1 : 0;
+    memcpy(out + len, s, n);
+    return len + n;
+}
+
+// printf one conversion with the argument's stored width (length modifiers in the
+// original spec are replaced, the argument type comes from the record)
+static size_t formatArg(char *out, size_t cap, const char *spec, size_t specLen, char conv, const DecodedArg &a)
+{
+    char fmt[24];
+    if (specLen > sizeof(fmt) - 4)
+        specLen = sizeof(fmt) - 4;
+    memcpy(fmt, spec, specLen);
+    size_t f = specLen;
+    int n = 0;
+    char tmp[LOG_MAX_STR_TOTAL + 1];
+
+    switch (conv)
+    {
+    case 'd':
+    case 'i':
+        fmt[f++] = 'l';
+        fmt[f++] = 'l';
+        fmt[f++] = 'd';
+        fmt[f] = '\0';
+        n = snprintf(out, cap, fmt, (long long)(a.tag == ARG_F64 ? (int64_t)a.d : a.i));
+        break;
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+        fmt[f++] = 'l';
+        fmt[f++] = 'l';
+        fmt[f++] = conv;
+        fmt[f] = '\0';
+        // 32-bit arguments keep printf's 32-bit unsigned view (e.g. %x of -1)
+        n = snprintf(out, cap, fmt, (unsigned long long)((a.tag == ARG_I32) ? (uint32_t)a.i : (uint64_t)a.i));
+        break;
+    case 'c':
+        fmt[f++] = 'c';
+        fmt[f] = '\0';
+        n = snprintf(out, cap, fmt, (int)a.i);
+        break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+        fmt[f++] = conv;
+        fmt[f] = '\0';
+        n = snprintf(out, cap, fmt, a.tag == ARG_F64 ? a.d : (double)a.i);
+        break;
+    case 's':
+        fmt[f++] = 's';
+        fmt[f] = '\0';
+        if (a.tag == ARG_STR)
+        {
+            memcpy(tmp, a.s, a.len);
+            tmp[a.len] = '\0';
+        }
+        else
+        {
+            strlcpy(tmp, "?", sizeof(tmp));
+        }
+        n = snprintf(out, cap, fmt, tmp);
+        break;
+    case 'p':
+        fmt[f++] = 'p';
+        fmt[f] = '\0';
+        n = snprintf(out, cap, fmt, (void *)(uintptr_t)a.i);
+        break;
+    default:
+        n = 0;
+        break;
+    }
+    if (n < 0)
+        return 0;
+    return ((size_t)n < cap) ? (size_t)n : (cap ? cap - 1 : 0);
+}
+
+// Render one record's message (without prefix/newline)
+static size_t formatMessage(const Header &h, const uint8_t *payload, const uint8_t *end, char *out, size_t cap)
+{
+    if (cap == 0)
+        return 0;
+    size_t len = 0;
+    if (h.kind == KIND_RAW)
+    {
+        len = appendStr(out, cap, 0, h.fmt, strlen(h.fmt));
+        out[len] = '\0';
+        return len;
+    }
+
+    DecodedArg args[LOG_MAX_ARGS];
+    const size_t nargs = decodeArgs(payload, end, h.nargs, args);
+    size_t next = 0;
+
+    for (const char *p = h.fmt; *p && len + 1 < cap;)
+    {
+        if (*p != '%')
+        {
+            const char *lit = p;
+            while (*p && *p != '%')
+                p++;
+            len = appendStr(out, cap, len, lit, p - lit);
+            continue;
+        }
+        if (p[1] == '%')
+        {
+            len = appendStr(out, cap, len, "%", 1);
+            p += 2;
+            continue;
+        }
+
+        // %[flags][width][.precision][length]conv
+        char spec[24];
+        size_t specLen = 0;
+        const char *q = p + 1;
+        spec[specLen++] = '%';
+        while (*q && strchr("-+ #0123456789.", *q) && specLen < sizeof(spec) - 1)
+            spec[specLen++] = *q++;
+        while (*q && strchr("hlLqjzt", *q))
+            q++;
+        const char conv = *q;
+        if (!conv)
+            break;
+        p = q + 1;
+
+        if (next >= nargs)
+        {
+            len = appendStr(out, cap, len, "?", 1);
+            continue;
+        }
+        len += formatArg(out + len, cap - len, spec, specLen, conv, args[next++]);
+    }
+    out[len] = '\0';
+    return len;
+}
+
+// Bytes needed for s once escaped for a JSON string
+static size_t escapedLength(const char *s, size_t n)
+{
+    size_t len = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        const uint8_t c = (uint8_t)s[i];
+        if (c == '"' || c == '\\' || c == '\n' || c == '\r' || c == '\t')
+            len += 2;
+        else if (c < 0x20)
+            len += 6;
+        else
+            len++;
+    }
+    return len;
+}
+
+static void writeEscaped(char *dst, const char *s, size_t n)
+{
+    static const char hex[] = "0123456789abcdef";
+    for (size_t i = 0; i < n; i++)
+    {
+        const uint8_t c = (uint8_t)s[i];
+        switch (c)
+        {
+        case '"':
+            *dst++ = '\\';
+            *dst++ = '"';
+            break;
+        case '\\':
+            *dst++ = '\\';
+            *dst++ = '\\';
+            break;
+        case '\n':
+            *dst++ = '\\';
+            *dst++ = 'n';
+            break;
+        case '\r':
+            *dst++ = '\\';
+            *dst++ = 'r';
+            break;
+        case '\t':
+            *dst++ = '\\';
+            *dst++ = 't';
+            break;
+        default:
+            if (c < 0x20)
+            {
+                memcpy(dst, "\\u00", 4);
+                dst[4] = hex[c >> 4];
+                dst[5] = hex[c & 15];
+                dst += 6;
+            }
+            else
+            {
+                *dst++ = (char)c;
+            }
+            break;
+        }
+    }
+}
+
+size_t logFormat(uint32_t &cursor, uint32_t end, char *out, size_t cap, LogEncoding enc)
+{
+    size_t len = 0;
+    if (cap == 0)
+        return 0;
+    out[0] = '\0';
+
+    uint8_t rec[LOG_MAX_RECORD + 8] __attribute__((aligned(8)));
+    char line[256];
+    for (;;)
+    {
+        const uint32_t head = writeHead.load(std::memory_order_acquire);
+        if ((int32_t)(head - cursor) < 0)
+            cursor = head;
+        if ((int32_t)(head - cursor) <= 0 || (int32_t)(end - cursor) <= 0)
+            break;
+        if (head - cursor > LOG_ARENA_SIZE)
+        {
+            cursor = resync(head);
+            continue;
+        }
+
+        const Header *h = headerAt(cursor);
+        if (__atomic_load_n(&h->pos, __ATOMIC_ACQUIRE) != cursor)
+            break; // reserved but not committed yet
+        const uint16_t recLen = h->len;
+        if (recLen < 8 || recLen > sizeof(rec) || (cursor & LOG_MASK) + recLen > LOG_ARENA_SIZE)
+        {
+            cursor = resync(head);
+            continue;
+        }
+        memcpy(rec, h, recLen);
+
+        // Writers reserve before writing: if nobody reserved past this record, the copy is intact
+        if (writeHead.load(std::memory_order_acquire) - cursor > LOG_ARENA_SIZE)
+            continue;
+
+        const Header &hdr = *reinterpret_cast<const Header *>(rec);
+        if (hdr.kind == KIND_PAD)
+        {
+            cursor += recLen;
+            continue;
+        }
+
+        int n = snprintf(line, sizeof(line), "[%lu] ", (unsigned long)hdr.ms);
+        if (n < 0)
+            n = 0;
+        size_t lineLen = (size_t)n;
+        lineLen += formatMessage(hdr, rec + sizeof(Header), rec + recLen, line + lineLen, sizeof(line) - lineLen - 1);
+        while (lineLen > 0 && (line[lineLen - 1] == '\n' || line[lineLen - 1] == '\r'))
+            lineLen--;
+        line[lineLen++] = '\n';
+
+        size_t need = (enc == LOG_JSON) ? escapedLength(line, lineLen) : lineLen;
+        if (len + need + 1 > cap)
+        {
+            if (len > 0)
+                break;
+            // Line alone does not fit: truncate it rather than stall the cursor
+            while (lineLen > 1 && need + 1 > cap)
+            {
+                line[--lineLen - 1] = '\n';
+                need = (enc == LOG_JSON) ? escapedLength(line, lineLen) : lineLen;
+            }
+            if (need + 1 > cap)
+            {
+                cursor += recLen;
+                continue;
+            }
+        }
+        if (enc == LOG_JSON)
+            writeEscaped(out + len, line, lineLen);
+        else
+            memcpy(out + len, line, lineLen);
+        len += need;
+        out[len] = '\0';
+        cursor += recLen;
+    }
+    return len;
+}
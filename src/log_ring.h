@@ -0,0 +1,218 @@
+#pragma once
+#include <Arduino.h>
+#include <string.h>
+#include <type_traits>
+
+// In-memory log for the web UI: a fixed byte arena holding binary records
+// (timestamp, format string pointer, raw arguments). Writers reserve space with a
+// CAS on the write position, so any task/core can log without locks or heap;
+// text is only produced when a reader asks for it (logFormat).
+//
+// Record positions are absolute byte offsets that only grow, and double as
+// sequence numbers: a cursor stays valid across calls and detects overruns.
+
+#define LOG_ARENA_SIZE 8192  // power of two
+#define LOG_MAX_ARGS 12
+#define LOG_MAX_STR_TOTAL 255 // characters of all string arguments of a record (a 256-byte line)
+#define LOG_MAX_RECORD (16 + LOG_MAX_ARGS * 9 + LOG_MAX_STR_TOTAL)
+
+namespace logring
+{
+    enum ArgTag : uint8_t
+    {
+        ARG_I32,
+        ARG_U32,
+        ARG_I64,
+        ARG_U64,
+        ARG_F64,
+        ARG_STR,
+        ARG_PTR
+    };
+
+    enum RecordKind : uint8_t
+    {
+        KIND_PAD = 0x50, // filler up to the arena end
+        KIND_FMT = 0x46, // printf format + encoded arguments
+        KIND_RAW = 0x52  // plain message in flash, printed verbatim
+    };
+
+    struct Header
+    {
+        uint32_t pos; // absolute position, stored last with release semantics (commit)
+        uint16_t len; // whole record, multiple of 8
+        uint8_t kind;
+        uint8_t nargs;
+        uint32_t ms;
+        const char *fmt;
+    };
+
+    static_assert(sizeof(Header) % 8 == 0, "log records must stay 8-byte aligned");
+
+    uint8_t *reserve(uint32_t len, uint32_t &pos);
+    void commit(uint8_t *rec, uint32_t pos, uint32_t len, RecordKind kind, uint8_t nargs, const char *fmt);
+
+    inline uint8_t *putRaw(uint8_t *p, ArgTag tag, const void *v, size_t n)
+    {
+        *p++ = tag;
+        memcpy(p, v, n);
+        return p + n;
+    }
+
+    // String lengths, taken once while sizing the record and reused when copying: the
+    // string arguments share the characters left in the line, in argument order
+    struct StrLens
+    {
+        size_t budget = LOG_MAX_STR_TOTAL;
+        uint8_t len[LOG_MAX_ARGS];
+        uint8_t count = 0;
+        uint8_t next = 0;
+    };
+
+    inline size_t sizeStr(const char *s, size_t maxLen, StrLens &l)
+    {
+        // Counted here rather than with strnlen: maxLen may exceed a shorter source array
+        const size_t limit = maxLen < l.budget ? maxLen : l.budget;
+        size_t n = 0;
+        if (s)
+            while (n < limit && s[n])
+                n++;
+        l.budget -= n;
+        l.len[l.count++] = (uint8_t)n;
+        return 2 + n;
+    }
+
+    inline uint8_t *putStr(uint8_t *p, const char *s, StrLens &l)
+    {
+        const uint8_t n = l.len[l.next++];
+        *p++ = ARG_STR;
+        *p++ = n;
+        memcpy(p, s, n);
+        return p + n;
+    }
+
+    template <typename T, typename Enable = void>
+    struct Arg;
+
+    template <typename T>
+    struct Arg<T, typename std::enable_if<std::is_integral<T>::value>::type>
+    {
+        static size_t size(const T &, StrLens &) { return 1 + (sizeof(T) > 4 ? 8 : 4); }
+        static uint8_t *put(uint8_t *p, const T &v, StrLens &)
+        {
+            if (sizeof(T) > 4)
+            {
+                const int64_t x = (int64_t)v;
+                return putRaw(p, std::is_signed<T>::value ? ARG_I64 : ARG_U64, &x, 8);
+            }
+            const int32_t x = (int32_t)v;
+            return putRaw(p, std::is_signed<T>::value ? ARG_I32 : ARG_U32, &x, 4);
+        }
+    };
+
+    template <typename T>
+    struct Arg<T, typename std::enable_if<std::is_enum<T>::value>::type>
+    {
+        static size_t size(const T &, StrLens &) { return 5; }
+        static uint8_t *put(uint8_t *p, const T &v, StrLens &)
+        {
+            const int32_t x = (int32_t)v;
+            return putRaw(p, ARG_I32, &x, 4);
+        }
+    };
+
+    template <typename T>
+    struct Arg<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+    {
+        static size_t size(const T &, StrLens &) { return 9; }
+        static uint8_t *put(uint8_t *p, const T &v, StrLens &)
+        {
+            const double x = (double)v;
+            return putRaw(p, ARG_F64, &x, 8);
+        }
+    };
+
+    // Strings are copied: callers pass stack buffers and temporaries (String::c_str())
+    template <typename T>
+    struct Arg<T, typename std::enable_if<std::is_pointer<T>::value &&
+                                          std::is_same<typename std::remove_cv<typename std::remove_pointer<T>::type>::type, char>::value>::type>
+    {
+        static size_t size(const T &s, StrLens &l) { return sizeStr(s, LOG_MAX_STR_TOTAL, l); }
+        static uint8_t *put(uint8_t *p, const T &s, StrLens &l) { return putStr(p, s, l); }
+    };
+
+    // Char arrays are never read past their end, even without a terminator
+    template <size_t N>
+    struct Arg<char[N]>
+    {
+        static size_t size(const char (&s)[N], StrLens &l) { return sizeStr(s, N, l); }
+        static uint8_t *put(uint8_t *p, const char (&s)[N], StrLens &l) { return putStr(p, s, l); }
+    };
+
+    template <size_t N>
+    struct Arg<const char[N]> : Arg<char[N]>
+    {
+    };
+
+    // Other arrays are logged as the pointer they decay to
+    template <typename T, size_t N>
+    struct Arg<T[N], typename std::enable_if<!std::is_same<typename std::remove_cv<T>::type, char>::value>::type>
+    {
+        static size_t size(const T (&)[N], StrLens &) { return 5; }
+        static uint8_t *put(uint8_t *p, const T (&v)[N], StrLens &)
+        {
+            const uint32_t x = (uint32_t)(uintptr_t)v;
+            return putRaw(p, ARG_PTR, &x, 4);
+        }
+    };
+
+    template <typename T>
+    struct Arg<T, typename std::enable_if<std::is_pointer<T>::value &&
+                                          !std::is_same<typename std::remove_cv<typename std::remove_pointer<T>::type>::type, char>::value>::type>
+    {
+        static size_t size(const T &, StrLens &) { return 5; }
+        static uint8_t *put(uint8_t *p, const T &v, StrLens &)
+        {
+            const uint32_t x = (uint32_t)(uintptr_t)v;
+            return putRaw(p, ARG_PTR, &x, 4);
+        }
+    };
+
+    inline size_t argsSize(StrLens &) { return 0; }
+    template <typename T, typename... Rest>
+    inline size_t argsSize(StrLens &l, const T &v, const Rest &...rest) { return Arg<T>::size(v, l) + argsSize(l, rest...); }
+
+    inline uint8_t *putArgs(uint8_t *p, StrLens &) { return p; }
+    template <typename T, typename... Rest>
+    inline uint8_t *putArgs(uint8_t *p, StrLens &l, const T &v, const Rest &...rest) { return putArgs(Arg<T>::put(p, v, l), l, rest...); }
+}
+
+// Append a printf-style record. fmt must point to static storage (string literal).
+template <typename... Args>
+inline void logPrintf(const char *fmt, const Args &...args)
+{
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "too many log arguments");
+    logring::StrLens lens;
+    const uint32_t len = (uint32_t)((sizeof(logring::Header) + logring::argsSize(lens, args...) + 7) & ~7u);
+    uint32_t pos;
+    uint8_t *rec = logring::reserve(len, pos);
+    logring::putArgs(rec + sizeof(logring::Header), lens, args...);
+    logring::commit(rec, pos, len, logring::KIND_FMT, (uint8_t)sizeof...(Args), fmt);
+}
+
+// Append a plain message (stored by pointer when it lives in flash, copied otherwise)
+void logPrint(const char *msg);
+
+// Position the next record will be written at
+uint32_t logHead();
+
+enum LogEncoding : uint8_t
+{
+    LOG_TEXT, // plain lines
+    LOG_JSON  // escaped for use inside a JSON string
+};
+
+// Format records from cursor up to end (usually a logHead() snapshot) as "[ms] message\n"
+// lines into out (whole lines only, NUL-terminated) and advance cursor past them.
+// Records overwritten before they were read are skipped; a cursor ahead of the ring
+// (e.g. from before a reboot) restarts at the current head. Returns the bytes written.
+size_t logFormat(uint32_t &cursor, uint32_t end, char *out, size_t cap, LogEncoding enc = LOG_TEXT);
@@ -1,12 +1,9 @@
 #include <Wire.h>
 #include <SPI.h>
 #include <GxEPD2_BW.h>
-#include <Fonts/FreeMonoBold12pt7b.h>
 #include <Adafruit_SHTC3.h>
 #include <stdlib.h>
 #include <string.h>
-#include "background.h"
-#include "fonts.h"
 #include "esp_sleep.h"
 #include "PCF85063A-SOLDERED.h"
 #include <WiFi.h>
@@ -17,6 +14,12 @@
 #include "utils.h"
 #include "mqtt.h"
 #include "web_server.h"
+#include "epd_frame.h"
+#include "perf.h"
+#include "history.h"
+#include "metrics_json.h"
+#include "sensor_filter.h"
+#include "clock_face.h"
 
 #define EPD_DC 10
 #define EPD_CS 11
@@ -34,6 +37,10 @@
 
 GxEPD2_BW<GxEPD2_154_D67, GxEPD2_154_D67::HEIGHT> display(
     GxEPD2_154_D67(EPD_CS, EPD_DC, EPD_RST, EPD_BUSY));
+// Offscreen frame the clock face is rendered into; only its diff is pushed to the panel
+static FrameCanvas frame(EPD_FRAME_WIDTH, EPD_FRAME_HEIGHT);
+// True once the panel has been initialized during this wake (needed before hibernate)
+static bool panelInitialized = false;
 
 Adafruit_SHTC3 shtc3;
 // RTC hardware removed: use system time (NTP) only
@@ -44,12 +51,18 @@ bool showSleepIndicator = false;
 int h = 0, m = 0;
 int voltageSegments = 0;
 
-String hourStr, minStr, tmp, hum2, tt, dateString;
-String days[7] = {"SU", "MO", "TU", "WE", "TH", "FR", "SA"};
+// Text shown on the clock face, formatted without heap allocations
+static char tt[6] = "00:00";            // HH:MM
+static char dateString[9] = "--/--/--"; // DD/MM/YY
+static char tmp[8] = "";
+static char hum2[8] = "";
 
 bool interactiveMode = false;
 // True when the next refresh must be full (first boot or wake button)
 static bool fullRefreshNext = false;
+// Timer wakes show the Wi-Fi state they sleep with ("WiFi OFF"), so an upload's short
+// association never changes the frame between the first draw and goDeepSleep()'s redraw
+static bool wifiShownOff = false;
 // Track last drawn minute in interactive mode (to refresh once per minute)
 static int lastRenderedMinute = -1;
 // Power button long-press tracking
@@ -58,49 +71,63 @@ static bool powerOffInitiated = false;
 
 static int readBatteryVoltage();
 void epdDraw(bool fullRefresh);
+static void renderFrame();
+static void beginPanel(bool initialRefresh);
 static void goDeepSleep();
 static uint32_t computeSleepSecondsAlignedToMinute();
 static const gpio_num_t WAKE_BUTTON = GPIO_NUM_0; // BOOT button (RTC-capable)
 static const gpio_num_t PWR_BUTTON = GPIO_NUM_18; // PWR button (active low)
 static const uint32_t POWER_BUTTON_LONG_MS = 1500;
-void readTimeAndSensorAndPrepareStrings(float &tempC, float &humidityPct, int &batteryMv);
+bool readTimeAndSensorAndPrepareStrings(float &tempC, float &humidityPct, int &batteryMv);
+static void prepareTimeStrings();
 static const char *applyTimezoneFromConfig();
 static void syncRtcFromNtpIfPossible();
-static void clearTextArea(const String &text, int cursorX, int cursorY, uint16_t pad, uint16_t color = GxEPD_WHITE);
 static void handlePowerButton(uint32_t nowMs);
 static void shutdownFromPowerButton();
 static void drawPowerOffScreen();
 // Latest metrics snapshot (kept for dashboard polling)
-static float latest_tempC = 0.0f;
-static float latest_humidity = 0.0f;
-static int latest_batteryMv = 0;
-static String latest_time_str = "";
-static String latest_date_str = "";
+static MetricsRecord latestMetrics = {};
+static char latest_time_str[sizeof(tt)] = "";
+static char latest_date_str[sizeof(dateString)] = "";
 
-// Counter stored in RTC memory to decide when to send MQTT while still waking every minute
+// Counter stored in RTC memory to decide when to upload the MQTT batch while still waking every minute
 RTC_DATA_ATTR uint32_t mqttMinuteCounter = 0;
+// A reading passed the report-on-change filter and has not been uploaded yet
+RTC_DATA_ATTR bool mqttReportPending = false;
 
-String getLatestMetricsJson()
+size_t formatLatestMetricsJson(char *out, size_t cap)
 {
-    // Build a compact JSON object string for metrics
-    String s = "";
-    s += "\"temp\":" + String(latest_tempC, 2) + ",";
-    s += "\"humidity\":" + String(latest_humidity, 2) + ",";
-    s += "\"battery_mv\":" + String(latest_batteryMv) + ",";
-    s += "\"time\":\"" + latest_time_str + "\",";
-    s += "\"date\":\"" + latest_date_str + "\"";
-    return s;
+    MetricsRecord r = latestMetrics;
+    r.time = latest_time_str;
+    r.date = latest_date_str;
+    return formatMetricsJson(out, cap, r, METRICS_WEB);
+}
+
+bool latestReading(float &tempC, float &humidityPct, int &batteryMv)
+{
+    const MetricsRecord r = latestMetrics;
+    if (r.tempCenti == METRICS_NO_VALUE || r.humCenti == METRICS_NO_VALUE)
+        return false;
+    tempC = r.tempCenti / 100.0f;
+    humidityPct = r.humCenti / 100.0f;
+    batteryMv = r.batteryMv;
+    return true;
 }
 
 static void goDeepSleep()
 {
+    // Batched history write (only every HISTORY_FLUSH_EVERY readings)
+    historyFlush(false);
+
     uint32_t sleepSeconds = computeSleepSecondsAlignedToMinute();
     // Request epdDraw to render the current page with a sleep indicator overlay
     showSleepIndicator = true;
     epdDraw(false);
     showSleepIndicator = false;
-    // Hibernate display after rendering
-    display.hibernate();
+    // Hibernate display after rendering (skipped if nothing was ever pushed this wake)
+    epdFrameJoin();
+    if (panelInitialized)
+        display.hibernate();
     digitalWrite(EPD_PWR, HIGH);
 
     gpio_hold_en((gpio_num_t)VBAT_PWR);
@@ -138,49 +165,46 @@ static uint32_t computeSleepSecondsAlignedToMinute()
     return sleepSec;
 }
 
-// Clear a text area (with padding) to a specific color before re-drawing dynamic content
-static void clearTextArea(const String &text, int cursorX, int cursorY, uint16_t pad, uint16_t color)
+static void formatWifiStatus(char *out, size_t cap)
 {
-    int16_t bx, by;
-    uint16_t bw, bh;
-    display.getTextBounds(text, cursorX, cursorY, &bx, &by, &bw, &bh);
-    int rx = bx - (int)pad;
-    int ry = by - (int)pad;
-    int rw = (int)bw + (int)pad * 2;
-    int rh = (int)bh + (int)pad * 2;
-    if (rx < 0)
-        rx = 0;
-    if (ry < 0)
-        ry = 0;
-    if (rx + rw > (int)display.width())
-        rw = (int)display.width() - rx;
-    if (ry + rh > (int)display.height())
-        rh = (int)display.height() - ry;
-    display.fillRect(rx, ry, rw, rh, color);
-}
+    if (wifiShownOff)
+    {
+        strlcpy(out, "WiFi OFF", cap);
+        return;
+    }
 
-static String getWifiStatusString()
-{
     wifi_mode_t mode = WiFi.getMode();
 
     // If STA connection is active
     if ((mode == WIFI_MODE_STA || mode == WIFI_MODE_APSTA) &&
         WiFi.status() == WL_CONNECTED)
     {
-        return String("STA ") + WiFi.localIP().toString();
+        const size_t n = strlcpy(out, "STA ", cap);
+        formatIp(out + n, cap - n, WiFi.localIP());
+        return;
     }
 
     // If an AP is active
     if (mode == WIFI_MODE_AP || mode == WIFI_MODE_APSTA)
     {
-        return String("AP ") + WiFi.softAPIP().toString();
+        const size_t n = strlcpy(out, "AP ", cap);
+        formatIp(out + n, cap - n, WiFi.softAPIP());
+        return;
     }
 
     // Otherwise Wi-Fi is off
-    return String("WiFi OFF");
+    strlcpy(out, "WiFi OFF", cap);
+}
+
+// "NN" with a leading zero, written at out[0..1]
+static void formatTwoDigits(char *out, int v)
+{
+    out[0] = (char)('0' + (v / 10) % 10);
+    out[1] = (char)('0' + v % 10);
 }
 
-void readTimeAndSensorAndPrepareStrings(float &tempC, float &humidityPct, int &batteryMv)
+// Format the clock and date text from the system time
+static void prepareTimeStrings()
 {
     struct tm timeinfo;
     // Try to get local time (NTP). If unavailable, fallback to epoch-based time(NULL)
@@ -193,74 +217,94 @@ void readTimeAndSensorAndPrepareStrings(float &tempC, float &humidityPct, int &b
         int month = timeinfo.tm_mon + 1;
         int year = (timeinfo.tm_year + 1900) % 100; // two-digit year for display
 
-        if (h < 10)
-            hourStr = "0" + String(h);
-        else
-            hourStr = String(h);
-
-        if (m < 10)
-            minStr = "0" + String(m);
-        else
-            minStr = String(m);
-
-        tt = hourStr + ":" + minStr;
-
-        String dayStr = (day < 10) ? "0" + String(day) : String(day);
-        String monthStr = (month < 10) ? "0" + String(month) : String(month);
-        String yearStr = (year < 10) ? "0" + String(year) : String(year);
-
-        dateString = dayStr + "/" + monthStr + "/" + yearStr;
+        formatTwoDigits(&tt[0], h);
+        formatTwoDigits(&tt[3], m);
+        formatTwoDigits(&dateString[0], day);
+        dateString[2] = '/';
+        formatTwoDigits(&dateString[3], month);
+        dateString[5] = '/';
+        formatTwoDigits(&dateString[6], year);
     }
     else
     {
         // Fallback: use previous h/m values and show placeholder date
-        if (h < 10)
-            hourStr = "0" + String(h);
-        else
-            hourStr = String(h);
-        if (m < 10)
-            minStr = "0" + String(m);
-        else
-            minStr = String(m);
-        tt = hourStr + ":" + minStr;
-        dateString = "--/--/--";
+        formatTwoDigits(&tt[0], h);
+        formatTwoDigits(&tt[3], m);
+        strlcpy(dateString, "--/--/--", sizeof(dateString));
+    }
+
+    memcpy(latest_time_str, tt, sizeof(tt));
+    memcpy(latest_date_str, dateString, sizeof(dateString));
+}
+
+// Returns false when the burst left no valid temperature or humidity: both are then NAN,
+// shown as "--" and must not be logged or published
+bool readTimeAndSensorAndPrepareStrings(float &tempC, float &humidityPct, int &batteryMv)
+{
+    prepareTimeStrings();
+
+    // Sample burst -> median of the plausible samples -> EMA kept across deep sleep
+    AppConfig cfg;
+    ConfigManager::instance().copySnapshot(cfg);
+    const uint16_t samples = constrain(cfg.median_n, 1, FILTER_MAX_SAMPLES);
+    float tSamples[FILTER_MAX_SAMPLES];
+    float hSamples[FILTER_MAX_SAMPLES];
+    float bSamples[FILTER_MAX_SAMPLES];
+    {
+        PERF_SCOPE(PERF_SENSOR_READ);
+        for (uint16_t i = 0; i < samples; i++)
+        {
+            if (i > 0 && cfg.median_delay_ms)
+                delay(cfg.median_delay_ms);
+            sensors_event_t hum, temp;
+            const bool ok = shtc3.getEvent(&hum, &temp);
+            tSamples[i] = ok ? temp.temperature : NAN;
+            hSamples[i] = ok ? hum.relative_humidity : NAN;
+        }
+    }
+    {
+        PERF_SCOPE(PERF_BATTERY_READ);
+        for (uint16_t i = 0; i < samples; i++)
+            bSamples[i] = (float)readBatteryVoltage();
     }
 
-    sensors_event_t hum, temp;
-    bool ok = shtc3.getEvent(&hum, &temp);
-    if (!ok)
+    const time_t nowEpoch = time(nullptr);
+    const uint32_t epoch = (nowEpoch >= (time_t)HISTORY_MIN_EPOCH) ? (uint32_t)nowEpoch : 0;
+    const float tMedian = filterMedian(tSamples, samples, filterBounds(SENSOR_TEMP));
+    const float hMedian = filterMedian(hSamples, samples, filterBounds(SENSOR_HUMIDITY));
+    const float bMedian = filterMedian(bSamples, samples, filterBounds(SENSOR_BATTERY));
+    const bool valid = !isnan(tMedian) && !isnan(hMedian);
+    if (!valid)
+        DEBUG_PRINT("[SENSORS][ERR] No valid SHTC3 sample, reading skipped.");
+    const float tSmooth = filterSmooth(SENSOR_TEMP, tMedian, cfg.avg_alpha, epoch);
+    const float hSmooth = filterSmooth(SENSOR_HUMIDITY, hMedian, cfg.avg_alpha_hum, epoch);
+    const float bSmooth = filterSmooth(SENSOR_BATTERY, bMedian, cfg.avg_alpha_batt, epoch);
+
+    // Offsets are applied after smoothing so a changed offset takes effect at once
+    tempC = valid ? tSmooth + cfg.temp_offset_c : NAN;
+    humidityPct = valid ? hSmooth + cfg.hum_offset_pct : NAN;
+    batteryMv = isnan(bSmooth) ? 0 : (int)lroundf(bSmooth);
     {
-        delay(5);
-        shtc3.getEvent(&hum, &temp);
+        PERF_ALLOC_SCOPE(PERF_TEXT_ALLOCS);
+        formatFixed(tmp, sizeof(tmp), tempC, 1);
+        formatFixed(hum2, sizeof(hum2), humidityPct, 1);
     }
 
-    tempC = temp.temperature;
-    humidityPct = hum.relative_humidity;
-    // Apply configurable offsets (temp in degC, humidity in % points)
-    float t_off = ConfigManager::instance().getTempOffsetC();
-    float h_off = ConfigManager::instance().getHumOffsetPct();
-    tempC += t_off;
-    humidityPct += h_off;
-    tmp = String(tempC, 1);
-    hum2 = String(humidityPct, 1);
-
-    batteryMv = readBatteryVoltage();
-    voltageSegments = map(batteryMv, 3100, 4200, 0, 5);
+    voltageSegments = map(batteryMv, BATTERY_EMPTY_MV, BATTERY_FULL_MV, 0, 5);
     if (voltageSegments < 0)
         voltageSegments = 0;
     if (voltageSegments > 5)
         voltageSegments = 5;
 
     // Update latest metrics snapshot for dashboard
-    latest_tempC = tempC;
-    latest_humidity = humidityPct;
-    latest_batteryMv = batteryMv;
-    latest_time_str = tt;
-    latest_date_str = dateString;
-
-    DEBUG_PRINTF("[SENSORS] %s %s -> T=%.1fC H=%.1f%% Batt=%dmV\n",
-                 tt.c_str(), dateString.c_str(),
-                 tempC, humidityPct, batteryMv);
+    latestMetrics.tempCenti = metricsCenti(tempC);
+    latestMetrics.humCenti = metricsCenti(humidityPct);
+    latestMetrics.batteryMv = batteryMv;
+
+    DEBUG_PRINTF("[SENSORS] %s %s -> T=%sC H=%s%% Batt=%dmV\n",
+                 tt, dateString, tmp, hum2, batteryMv);
+    webPushMetrics();
+    return valid;
 }
 
 // Ensure TZ environment is set even if NTP/Wi-Fi is unavailable
@@ -268,7 +312,8 @@ static const char *applyTimezoneFromConfig()
 {
     static char tzBuf[TZ_STRING_LEN];
 
-    const auto cfg = ConfigManager::instance().getConfig();
+    AppConfig cfg;
+    ConfigManager::instance().copySnapshot(cfg);
     const char *tz = cfg.tz_string;
     if (!tz || strlen(tz) == 0)
     {
@@ -291,6 +336,7 @@ static void syncRtcFromNtpIfPossible()
         return;
     }
 
+    PERF_SCOPE(PERF_NTP_SYNC);
     DEBUG_PRINTF("[NTP] Sync NTP (TZ=\"%s\")...\n", tz);
 
     // Initialize SNTP + timezone (with automatic DST handling)
@@ -313,28 +359,24 @@ static void syncRtcFromNtpIfPossible()
 // Render a short confirmation before cutting VBAT power (long press on PWR)
 static void drawPowerOffScreen()
 {
-    SPI.begin(EPD_SCK, -1, EPD_MOSI, EPD_CS);
-    display.epd2.selectSPI(SPI, SPISettings(SPI_CLOCK_HZ, MSBFIRST, SPI_MODE0));
-    display.init(115200, true);
-    display.setRotation(0);
+    beginPanel(true);
+    // Drawn through the paged GxEPD2 buffer: the retained frame no longer matches the panel
+    epdFrameInvalidate();
     display.setFullWindow();
     display.firstPage();
     do
     {
-        display.fillRect(0, 0, display.width(), display.height(), GxEPD_WHITE);
-        display.setTextColor(GxEPD_BLACK);
-        display.setFont(&DejaVu_Sans_Condensed_Bold_18);
-        display.setCursor(36, 102);
-        display.print("Powering off");
-        display.setFont(&DejaVu_Sans_Condensed_Bold_15);
-        display.setCursor(36, 126);
-        display.print("VBAT disabled");
+        clockFaceDrawPowerOff(display);
     } while (display.nextPage());
 }
 
 // Long-press PWR button -> disable VBAT rail and halt (mirrors Waveshare test)
 static void shutdownFromPowerButton()
 {
+    // RTC memory is lost with VBAT: write out every queued reading
+    historyFlush(true);
+    mqttSessionStop();
+    spillMQTT_backlog();
     disconnectWiFiClean();
     drawPowerOffScreen();
     display.hibernate();
@@ -383,169 +425,98 @@ static void handlePowerButton(uint32_t nowMs)
     }
 }
 
-void epdDraw(bool fullRefresh)
+// Power up the SPI link and the panel controller before pushing pixels
+static void beginPanel(bool initialRefresh)
 {
+    // The previous waveform may still be running in the background
+    epdFrameJoin();
     SPI.begin(EPD_SCK, -1, EPD_MOSI, EPD_CS);
     display.epd2.selectSPI(SPI, SPISettings(SPI_CLOCK_HZ, MSBFIRST, SPI_MODE0));
 
     // Skip the library's initial full clear when we only want a partial (avoids black/white flash)
-    display.init(115200, fullRefresh /*initial full refresh*/);
+    display.init(115200, initialRefresh /*initial full refresh*/);
     display.setRotation(0);
-    if (fullRefresh)
+    // Sleep through the waveform on the BUSY edge instead of polling the pin every millisecond
+    epdBusyWaitInstall(display.epd2, EPD_BUSY, HIGH);
+    panelInitialized = true;
+}
+
+// Render and start the refresh; the waveform runs in the background until epdFrameJoin()
+void epdDraw(bool fullRefresh)
+{
+    // The frame being pushed must not be redrawn underneath the background task
+    epdFrameJoin();
     {
-        display.setFullWindow();
+        PERF_SCOPE(PERF_EPD_RENDER);
+        renderFrame();
     }
-    else
+
+    EpdWindow win;
+    if (!epdFrameDiff(frame.getBuffer(), fullRefresh, win))
     {
-        // Partial window refresh to avoid the multi-phase black/white flash
-        display.setPartialWindow(0, 0, display.width(), display.height());
+        DEBUG_PRINT("[EPD] Frame unchanged, refresh skipped.");
+        return;
     }
 
-    display.firstPage();
-    do
-    {
-        display.drawBitmap(0, 0, backImage, 200, 200, GxEPD_BLACK);
-
-        display.fillRect(60, 137, 124, 5, GxEPD_BLACK);
-        display.fillRect(120, 82, 60, 2, GxEPD_BLACK);
-        display.fillRect(10, 42, 3, 129, GxEPD_BLACK);
-
-        display.drawRect(150, 8, 40, 16, GxEPD_BLACK);
-        display.drawRect(151, 9, 38, 14, GxEPD_BLACK);
-        display.fillRect(190, 12, 3, 7, GxEPD_BLACK);
-        for (int i = 0; i < voltageSegments; i++)
-            display.fillRect(154 + (i * 7), 12, 4, 8, GxEPD_BLACK);
-
-        display.fillRoundRect(20, 40, 95, 45, 5, GxEPD_BLACK);
-
-        display.fillRoundRect(35, 143, 15, 40, 8, GxEPD_BLACK);
-        display.fillCircle(42, 173, 10, GxEPD_BLACK);
-        display.fillRoundRect(37, 145, 11, 36, 8, GxEPD_WHITE);
-        display.fillCircle(42, 173, 8, GxEPD_WHITE);
-        display.fillRoundRect(40, 153, 5, 25, 2, GxEPD_BLACK);
-        display.fillCircle(42, 173, 5, GxEPD_BLACK);
-
-        for (int i = 0; i < 6; i++)
-            display.fillCircle(122, 170 - (i * 3), 6 - i, GxEPD_BLACK);
-
-        display.fillRoundRect(152, 94, 30, 22, 4, GxEPD_BLACK);
-
-        display.setTextColor(GxEPD_BLACK);
-        display.setFont(&DSEG7_Classic_Bold_36);
-        clearTextArea(tt, 18, 130, 2);
-        display.setCursor(18, 130);
-        display.print(tt);
-
-        display.setFont(&DejaVu_Sans_Condensed_Bold_15);
-        display.setTextColor(GxEPD_WHITE);
-        display.setCursor(27, 57);
-        display.print("DATE");
-
-        display.setTextColor(GxEPD_BLACK);
-        display.setCursor(60, 161);
-        clearTextArea("TEMP", 60, 161, 2);
-        display.print("TEMP");
-        display.setCursor(60, 177);
-        clearTextArea(tmp, 60, 177, 2);
-        display.print(tmp);
-        display.setCursor(135, 161);
-        clearTextArea("HUM", 135, 161, 2);
-        display.print("HUM");
-        display.setCursor(135, 177);
-        clearTextArea(hum2, 135, 177, 2);
-        display.print(hum2);
-        display.setCursor(120, 78);
-        // Display "MQTT" if enabled
-        if (ConfigManager::instance().getConfig().mqtt_enabled)
-        {
-            clearTextArea("MQTT", 120, 78, 2);
-            display.print("MQTT");
-        }
+    const uint32_t refreshStart = micros();
+    beginPanel(fullRefresh);
+    epdFramePushAsync(display.epd2, frame.getBuffer(), fullRefresh, win, refreshStart);
+}
 
-        display.setTextColor(GxEPD_WHITE);
-        display.setCursor(156, 110);
-        display.print(days[sys_wday]);
-
-        display.setFont(&DejaVu_Sans_Condensed_Bold_18);
-        display.setTextColor(GxEPD_WHITE);
-        clearTextArea(dateString, 27, 76, 3, GxEPD_BLACK);
-        display.setCursor(27, 76);
-        display.print(dateString);
-
-        display.setTextColor(GxEPD_BLACK);
-        display.setFont(&DejaVu_Sans_Condensed_Bold_23);
-        // Show application version instead of static label
-        display.setCursor(120, 62);
-        display.print(ConfigManager::instance().getConfig().app_version);
-
-        // Wi-Fi status: AP/STA + IP
-        String wifiStr = getWifiStatusString();
-
-        display.setFont(&DejaVu_Sans_Condensed_Bold_15); // small readable font
-        int16_t tbx, tby;
-        uint16_t tbw, tbh;
-        const int textX = 40;
-        const int textY = 200;
-        display.getTextBounds(wifiStr, textX, textY, &tbx, &tby, &tbw, &tbh);
-        int pad = 4; // small padding around text
-        int rectX = tbx - pad;
-        int rectY = tby - pad;
-        int rectW = tbw + (pad * 2);
-        int rectH = tbh + (pad * 2);
-        if (rectX < 0)
-            rectX = 0;
-        if (rectY < 0)
-            rectY = 0;
-        if (rectX + rectW > 200)
-            rectW = 200 - rectX;
-        if (rectY + rectH > 200)
-            rectH = 200 - rectY;
-        display.fillRect(rectX, rectY, rectW, rectH, GxEPD_WHITE);
-        display.setTextColor(GxEPD_BLACK);
-        // Bottom of the screen (y ~= 195 on a 200px tall display)
-        display.setCursor(textX, textY);
-        display.print(wifiStr);
-
-        // Display device name at the top-right area (replaces VOLOS from bitmap)
-        const char *devName = ConfigManager::instance().getConfig().device_name;
-        if (devName && strlen(devName) > 0)
-        {
-            display.setFont(&DejaVu_Sans_Condensed_Bold_18);
-            int16_t nbx, nby;
-            uint16_t nbw, nbh;
-            const int nameX = 30;
-            const int nameY = 25;
-            display.getTextBounds(devName, nameX, nameY, &nbx, &nby, &nbw, &nbh);
-            int npad = 4;
-            int nrectX = nbx - npad;
-            int nrectY = nby - npad;
-            int nrectW = nbw + (npad * 2);
-            int nrectH = nbh + (npad * 2);
-            if (nrectX < 0)
-                nrectX = 0;
-            if (nrectY < 0)
-                nrectY = 0;
-            if (nrectX + nrectW > 200)
-                nrectW = 200 - nrectX;
-            if (nrectY + nrectH > 200)
-                nrectH = 200 - nrectY;
-            display.fillRect(nrectX, nrectY, nrectW, nrectH, GxEPD_WHITE);
-            display.setTextColor(GxEPD_BLACK);
-            display.setCursor(nameX, nameY);
-            display.print(devName);
-        }
+// Draw the whole clock face into the offscreen frame
+static void renderFrame()
+{
+    PERF_ALLOC_SCOPE(PERF_TEXT_ALLOCS);
+    AppConfig cfg;
+    ConfigManager::instance().copySnapshot(cfg);
+
+    char wifiStr[24];
+    formatWifiStatus(wifiStr, sizeof(wifiStr));
+    const ClockFaceText text = {tt, dateString, tmp, hum2, wifiStr,
+                                (uint8_t)sys_wday, (uint8_t)voltageSegments, showSleepIndicator};
+    clockFaceRender(frame, text, cfg);
+}
+
+// Interactive mode: queued readings are published by the MQTT session task
+static void queueInteractiveReading(float tempC, float humidityPct, int batteryMv)
+{
+    AppConfig cfg;
+    ConfigManager::instance().copySnapshot(cfg);
+    const uint32_t now = (uint32_t)time(nullptr);
+    if (cfg.mqtt_enabled && mqttShouldReport(cfg, now, tempC, humidityPct))
+        queueMQTT_reading(now, tempC, humidityPct, batteryMv);
+}
+
+// Carry out commands received on <topic>/cmd; returns true when a reading was queued for MQTT
+static bool handleMqttCommands()
+{
+    const uint32_t cmds = mqttTakeCommands();
+    if (cmds == 0)
+        return false;
+    DEBUG_PRINTF("[MQTT] Handling commands 0x%02lx\n", (unsigned long)cmds);
 
-        // If requested, draw a small sleep indicator overlay in the top-left corner
-        if (showSleepIndicator)
+    if (cmds & MQTT_CMD_CONFIG)
+    {
+        // Applied without the async save: on flash before deep sleep or a power cut
+        ConfigManager::instance().save();
+        applyTimezoneFromConfig();
+    }
+
+    // A configuration update takes effect with the next scheduled reading
+    bool queued = false;
+    if (cmds & MQTT_CMD_READ)
+    {
+        float t = 0.0f, h = 0.0f;
+        int batt = 0;
+        if (readTimeAndSensorAndPrepareStrings(t, h, batt) && ConfigManager::instance().snapshot().mqtt_enabled)
         {
-            display.setFont(&DejaVu_Sans_Condensed_Bold_15);
-            display.setTextColor(GxEPD_WHITE);
-            display.fillRect(0, 0, 28, 18, GxEPD_BLACK);
-            display.setCursor(4, 14);
-            display.print("Zz");
+            queueMQTT_reading((uint32_t)time(nullptr), t, h, batt);
+            queued = true;
         }
+    }
 
-    } while (display.nextPage());
+    epdDraw((cmds & MQTT_CMD_REFRESH) != 0);
+    return queued;
 }
 
 void setup()
@@ -573,6 +544,8 @@ void setup()
 
     delay(10);
 
+    clockFaceBegin(frame);
+
     Wire.begin(I2C_SDA, I2C_SCL);
     shtc3.begin();
 
@@ -603,6 +576,11 @@ void setup()
         DEBUG_PRINT("[MODE] Wakeup via BOOT button -> full EPD refresh");
     }
 
+    // Interactive mode always needs the network: associate on the other core while the
+    // sensors are read and the first frame is drawn (connectWiFiShort() joins it)
+    if (!wokeFromTimer)
+        connectWiFiAsync(8000);
+
     float tempC = 0.0f;
     float humidity = 0.0f;
     int batteryMv = 0;
@@ -610,13 +588,34 @@ void setup()
     if (cause == ESP_SLEEP_WAKEUP_TIMER)
     {
         DEBUG_PRINT("[MODE] TIMER wakeup -> measurement + deep sleep mode");
+        wifiShownOff = true;
 
         const auto cfg = ConfigManager::instance().getConfig();
         const uint32_t mqttInterval = cfg.deepsleep_interval_min ? cfg.deepsleep_interval_min : 5;
+
+        // An upload already pending is due whatever this reading says: associate in the background
+        if (cfg.mqtt_enabled && mqttReportPending && mqttMinuteCounter >= mqttInterval)
+            connectWiFiAsync(6000);
+
+        // Always set TZ; only sync via NTP when Wi-Fi will be used
+        applyTimezoneFromConfig();
+
+        // Read first: whether the radio is needed depends on how much the values changed
+        const bool valid = readTimeAndSensorAndPrepareStrings(tempC, humidity, batteryMv);
+        const uint32_t now = (uint32_t)time(nullptr);
+        if (valid)
+            historyAppend(now, tempC, humidity, batteryMv);
+        if (valid && cfg.mqtt_enabled && mqttShouldReport(cfg, now, tempC, humidity))
+        {
+            queueMQTT_reading(now, tempC, humidity, batteryMv);
+            mqttReportPending = true;
+        }
+
+        // Upload when something is pending, at most every deepsleep_interval_min
         bool mqttDue = false;
         if (cfg.mqtt_enabled && mqttInterval > 0)
         {
-            if (mqttMinuteCounter >= mqttInterval)
+            if (mqttReportPending && mqttMinuteCounter >= mqttInterval)
             {
                 mqttDue = true;
                 mqttMinuteCounter = 0;
@@ -626,50 +625,59 @@ void setup()
         {
             mqttMinuteCounter = 0;
         }
-
-        // Always set TZ; only sync via NTP when Wi-Fi will be used
-        applyTimezoneFromConfig();
-
-        bool wifiOK = false;
+        // Due because of this reading: still associates while the frame is rendered and pushed
         if (mqttDue)
-        {
-            wifiOK = connectWiFiShort(6000);
-            if (wifiOK)
-            {
-                syncRtcFromNtpIfPossible();
-            }
-        }
+            connectWiFiAsync(6000);
 
-        // Re-read the current time (may have been updated) and sensors
-        readTimeAndSensorAndPrepareStrings(tempC, humidity, batteryMv);
+        // Render the sleep indicator right away. The Wi-Fi status is fixed for the whole wake, so
+        // goDeepSleep()'s redraw finds nothing to refresh unless an MQTT command changed the face.
+        // The panel waveform runs while Wi-Fi, NTP and MQTT do their work below.
+        showSleepIndicator = true;
+        epdDraw(false);
 
-        if (mqttDue && wifiOK)
+        if (mqttDue && connectWiFiShort(6000))
         {
-            epdDraw(false);
-            publishMQTT_reading(tempC, humidity, batteryMv);
+            syncRtcFromNtpIfPossible();
+            // One broker session for every reading queued since the last upload (and any offline backlog)
+            if (publishMQTT_backlog())
+                mqttReportPending = false;
+            // Retained commands arrive with that session; a requested reading goes out right away
+            if (handleMqttCommands())
+                publishMQTT_backlog();
             disconnectWiFiClean();
         }
-        else
-        {
-            epdDraw(false);
-        }
 
+        perfRecord(PERF_WAKE_TOTAL, micros());
         goDeepSleep();
     }
     else
     {
-        // Boot/reset: interactive mode + web server
+        // Boot/reset: interactive mode + web server.
+        // First frame while Wi-Fi associates in the background (time kept by the RTC domain, if any)
+        applyTimezoneFromConfig();
+        const bool valid = readTimeAndSensorAndPrepareStrings(tempC, humidity, batteryMv);
+        epdDraw(fullRefreshNext);
+        fullRefreshNext = false;
+
+        // Waits for the association (access point fallback on failure)
         startWebServer();
+        // Persistent broker session for the interactive period (idle while MQTT is disabled)
+        mqttSessionStart();
 
         // Apply TZ always; perform NTP sync when possible
         syncRtcFromNtpIfPossible();
 
-        readTimeAndSensorAndPrepareStrings(tempC, humidity, batteryMv);
+        // Clock and network status may only be known now: log the reading with that time and
+        // redraw (the frame diff skips the refresh when nothing moved)
+        prepareTimeStrings();
+        epdDraw(false);
+        if (valid)
+        {
+            historyAppend((uint32_t)time(nullptr), tempC, humidity, batteryMv);
+            queueInteractiveReading(tempC, humidity, batteryMv);
+        }
         lastRenderedMinute = m;
 
-        epdDraw(fullRefreshNext);
-        fullRefreshNext = false;
-
         interactiveMode = true;
         interactiveLastTouchMs.store(millis());
     }
@@ -696,13 +704,29 @@ void loop()
                     lastRenderedMinute = ti.tm_min;
                     float t = 0.0f, h = 0.0f;
                     int batt = 0;
-                    readTimeAndSensorAndPrepareStrings(t, h, batt);
+                    if (readTimeAndSensorAndPrepareStrings(t, h, batt))
+                    {
+                        historyAppend((uint32_t)time(nullptr), t, h, batt);
+                        queueInteractiveReading(t, h, batt);
+                    }
                     epdDraw(false);
+                    historyFlush(false);
                 }
             }
         }
 
-        const uint32_t timeoutMin = ConfigManager::instance().getConfig().interactive_timeout_min;
+        webServiceEvents();
+        if (webTakeConfigApplied())
+        {
+            float t = 0.0f, h = 0.0f;
+            int batt = 0;
+            readTimeAndSensorAndPrepareStrings(t, h, batt);
+            epdDraw(false);
+        }
+        // Readings queued here are published by the MQTT session task
+        handleMqttCommands();
+
+        const uint32_t timeoutMin = ConfigManager::instance().snapshot().interactive_timeout_min;
         const uint32_t timeout = (timeoutMin ? timeoutMin : 5) * 60000UL;
         const uint32_t last = interactiveLastTouchMs.load();
 
@@ -717,6 +741,7 @@ void loop()
             }
             else
             {
+                mqttSessionStop();
                 disconnectWiFiClean();
                 delay(50);
                 goDeepSleep();
@@ -0,0 +1,213 @@
+#include "metrics_json.h"
+#include "json_writer.h"
+
+enum MetricsField : uint8_t
+{
+    FIELD_TEMP,
+    FIELD_HUMIDITY,
+    FIELD_BATTERY_MV,
+    FIELD_BATTERY_PCT,
+    FIELD_RSSI,
+    FIELD_TIME,
+    FIELD_DATE,
+    FIELD_TS
+};
+
+struct MetricsFieldDef
+{
+    MetricsField field;
+    JsonKey keys[METRICS_SCHEMA_COUNT]; // JSON_NO_KEY = not part of that schema
+};
+
+// The one place that defines order, names and format of the published fields
+static const MetricsFieldDef METRICS_FIELDS[] = {
+    {FIELD_TEMP, {JSON_KEY("temp"), JSON_KEY("temperature_c")}},
+    {FIELD_HUMIDITY, {JSON_KEY("humidity"), JSON_KEY("humidity_pct")}},
+    {FIELD_BATTERY_MV, {JSON_KEY("battery_mv"), JSON_KEY("battery_mv")}},
+    {FIELD_BATTERY_PCT, {JSON_NO_KEY, JSON_KEY("battery_pct")}},
+    {FIELD_RSSI, {JSON_NO_KEY, JSON_KEY("rssi")}},
+    {FIELD_TIME, {JSON_KEY("time"), JSON_NO_KEY}},
+    {FIELD_DATE, {JSON_KEY("date"), JSON_NO_KEY}},
+    {FIELD_TS, {JSON_NO_KEY, JSON_KEY("ts")}},
+};
+
+int32_t metricsCenti(float v)
+{
+    // float * 100 is exact in double; rint rounds ties to even, matching "%.2f"
+    const double scaled = rint((double)v * 100.0);
+    // Negated comparison so NaN lands here too: converting it to int32 is undefined
+    if (!(scaled > (double)INT32_MIN && scaled <= (double)INT32_MAX))
+        return METRICS_NO_VALUE;
+    return (int32_t)scaled;
+}
+
+static void writeCenti(JsonWriter &w, int32_t centi)
+{
+    if (centi == METRICS_NO_VALUE)
+        w.raw("null");
+    else
+        w.fixed<2>(centi);
+}
+
+int32_t metricsBatteryPct(int32_t batteryMv)
+{
+    const int32_t pct = (batteryMv - BATTERY_EMPTY_MV) * 100 / (BATTERY_FULL_MV - BATTERY_EMPTY_MV);
+    return pct < 0 ? 0 : (pct > 100 ? 100 : pct);
+}
+
+size_t formatMetricsJson(char *out, size_t cap, const MetricsRecord &r, MetricsSchema schema)
+{
+    JsonWriter w(out, cap);
+    w.beginObject();
+    for (const MetricsFieldDef &def : METRICS_FIELDS)
+    {
+        const JsonKey &key = def.keys[schema];
+        if (!key.text)
+            continue;
+        switch (def.field)
+        {
+        case FIELD_TEMP:
+            w.key(key);
+            writeCenti(w, r.tempCenti);
+            break;
+        case FIELD_HUMIDITY:
+            w.key(key);
+            writeCenti(w, r.humCenti);
+            break;
+        case FIELD_BATTERY_MV:
+            w.key(key);
+            w.i32(r.batteryMv);
+            break;
+        case FIELD_BATTERY_PCT:
+            w.key(key);
+            w.i32(metricsBatteryPct(r.batteryMv));
+            break;
+        case FIELD_RSSI:
+            if (r.rssi)
+            {
+                w.key(key);
+                w.i32(r.rssi);
+            }
+            break;
+        case FIELD_TIME:
+        case FIELD_DATE:
+        {
+            const char *s = (def.field == FIELD_TIME) ? r.time : r.date;
+            if (s)
+            {
+                w.key(key);
+                w.str(s);
+            }
+            break;
+        }
+        case FIELD_TS:
+            if (r.epoch)
+            {
+                w.key(key);
+                w.u32(r.epoch);
+            }
+            break;
+        }
+    }
+    w.endObject();
+    return w.ok() ? w.length() : 0;
+}
+
+// ---------- Home Assistant discovery ----------
+
+struct DiscoverySensor
+{
+    MetricsField field; // value_json key comes from the MQTT key set above
+    const char *object;
+    const char *name;
+    const char *unit;
+    const char *deviceClass;
+    bool diagnostic;
+};
+
+static const DiscoverySensor DISCOVERY_SENSORS[] = {
+    {FIELD_TEMP, "temperature", "Temperature", "\u00b0C", "temperature", false},
+    {FIELD_HUMIDITY, "humidity", "Humidity", "%", "humidity", false},
+    {FIELD_BATTERY_PCT, "battery", "Battery", "%", "battery", false},
+    {FIELD_BATTERY_MV, "battery_mv", "Battery voltage", "mV", "voltage", true},
+    {FIELD_RSSI, "rssi", "Wi-Fi signal", "dBm", "signal_strength", true},
+};
+
+size_t metricsDiscoveryCount()
+{
+    return sizeof(DISCOVERY_SENSORS) / sizeof(DISCOVERY_SENSORS[0]);
+}
+
+static const JsonKey *mqttKeyFor(MetricsField field)
+{
+    for (const MetricsFieldDef &def : METRICS_FIELDS)
+        if (def.field == field)
+            return &def.keys[METRICS_MQTT];
+    return nullptr;
+}
+
+size_t formatMetricsDiscovery(char *out, size_t cap, size_t index, const MetricsDevice &dev,
+                              char *objectId, size_t objectIdCap)
+{
+    if (index >= metricsDiscoveryCount())
+        return 0;
+    const DiscoverySensor &s = DISCOVERY_SENSORS[index];
+    const JsonKey *key = mqttKeyFor(s.field);
+    if (!key || !key->text)
+        return 0;
+    strlcpy(objectId, s.object, objectIdCap);
+
+    // Field name without the quotes and colon baked into the key
+    char tpl[48];
+    snprintf(tpl, sizeof(tpl), "{{value_json.%.*s}}", (int)(key->len - 3), key->text + 1);
+    char uniqueId[48];
+    snprintf(uniqueId, sizeof(uniqueId), "%s_%s", dev.nodeId, s.object);
+
+    static const JsonKey K_NAME = JSON_KEY("name");
+    static const JsonKey K_UNIQ = JSON_KEY("uniq_id");
+    static const JsonKey K_STATE = JSON_KEY("stat_t");
+    static const JsonKey K_TPL = JSON_KEY("val_tpl");
+    static const JsonKey K_UNIT = JSON_KEY("unit_of_meas");
+    static const JsonKey K_CLASS = JSON_KEY("dev_cla");
+    static const JsonKey K_STATE_CLASS = JSON_KEY("stat_cla");
+    static const JsonKey K_ENTITY_CAT = JSON_KEY("ent_cat");
+    static const JsonKey K_DEVICE = JSON_KEY("dev");
+    static const JsonKey K_IDS = JSON_KEY("ids");
+    static const JsonKey K_MODEL = JSON_KEY("mdl");
+    static const JsonKey K_SW = JSON_KEY("sw");
+
+    JsonWriter w(out, cap);
+    w.beginObject();
+    w.key(K_NAME);
+    w.str(s.name);
+    w.key(K_UNIQ);
+    w.str(uniqueId);
+    w.key(K_STATE);
+    w.str(dev.stateTopic);
+    w.key(K_TPL);
+    w.str(tpl);
+    w.key(K_UNIT);
+    w.str(s.unit);
+    w.key(K_CLASS);
+    w.str(s.deviceClass);
+    w.key(K_STATE_CLASS);
+    w.raw("\"measurement\"");
+    if (s.diagnostic)
+    {
+        w.key(K_ENTITY_CAT);
+        w.raw("\"diagnostic\"");
+    }
+    w.key(K_DEVICE);
+    w.beginObject();
+    w.key(K_IDS);
+    w.str(dev.nodeId);
+    w.key(K_NAME);
+    w.str(dev.name);
+    w.key(K_MODEL);
+    w.raw("\"ESP32-S3 ePaper 1.54\"");
+    w.key(K_SW);
+    w.str(dev.swVersion);
+    w.endObject();
+    w.endObject();
+    return w.ok() ? w.length() : 0;
+}
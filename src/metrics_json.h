@@ -0,0 +1,50 @@
+#pragma once
+#include <Arduino.h>
+
+// Battery range used for the display segments and the published percentage
+#define BATTERY_EMPTY_MV 3100
+#define BATTERY_FULL_MV 4200
+
+// tempCenti / humCenti without a reading (NaN sensor value), written as null
+#define METRICS_NO_VALUE INT32_MIN
+
+// One reading as published to the web UI and MQTT, already in fixed point
+struct MetricsRecord
+{
+    int32_t tempCenti; // METRICS_NO_VALUE = null
+    int32_t humCenti;  // METRICS_NO_VALUE = null
+    int32_t batteryMv;
+    uint32_t epoch;   // 0 = no timestamp (before NTP sync), omitted
+    const char *time; // display strings, omitted when null
+    const char *date;
+    int8_t rssi; // dBm, 0 = omitted
+};
+
+// Key sets of the same field schema
+enum MetricsSchema : uint8_t
+{
+    METRICS_WEB,  // dashboard / SSE: temp, humidity, battery_mv, time, date
+    METRICS_MQTT, // state topic: temperature_c, humidity_pct, battery_mv, battery_pct, rssi, ts
+    METRICS_SCHEMA_COUNT
+};
+
+// v * 100 rounded; METRICS_NO_VALUE for NaN or anything outside the int32 range
+int32_t metricsCenti(float v);
+int32_t metricsBatteryPct(int32_t batteryMv);
+
+// Write the record as a JSON object; returns the length (0 if it did not fit)
+size_t formatMetricsJson(char *out, size_t cap, const MetricsRecord &r, MetricsSchema schema);
+
+// Home Assistant MQTT discovery: one sensor per field of the MQTT state payload
+struct MetricsDevice
+{
+    const char *nodeId; // unique per device, used in topics and unique_id
+    const char *name;
+    const char *stateTopic;
+    const char *swVersion;
+};
+
+size_t metricsDiscoveryCount();
+// Compact (abbreviated keys) config payload for sensor index; objectId receives the topic component
+size_t formatMetricsDiscovery(char *out, size_t cap, size_t index, const MetricsDevice &dev,
+                              char *objectId, size_t objectIdCap);
@@ -1,82 +1,711 @@
 #include "mqtt.h"
 #include "config.h"
 #include "config_manager.h"
+#include "perf.h"
+#include "history.h"
+#include "metrics_json.h"
 #include <WiFi.h>
 #include <PubSubClient.h>
+#include <LittleFS.h>
+#include <ArduinoJson.h>
 #include <atomic>
+#include <mutex>
+
+#define MQTT_CLIENT_WAIT_MS 500       // one-shot publishes wait this long for the session task
+#define MQTT_SESSION_TICK_MS 100
+#define MQTT_BACKOFF_MIN_MS 2000
+#define MQTT_BACKOFF_MAX_MS 60000
+// Bounds a broker connect (TCP connect, then CONNACK), so a stop never waits on a default
+// 3 s connect plus 15 s CONNACK timeout; the stop budget covers both plus the DNS lookup
+#define MQTT_SOCKET_TIMEOUT_S 2
+#define MQTT_SESSION_STOP_MS 6000
+#define MQTT_CMD_WAIT_MS 300 // after subscribing, time for a retained command to arrive on timer wakes
+#define MQTT_DISCOVERY_PREFIX "homeassistant"
+#define MQTT_DISCOVERY_VERSION 1 // bump when the discovery payloads change
+
+struct QueuedReading
+{
+    uint32_t epoch;
+    int16_t tempCenti;
+    uint16_t humCenti;
+    uint16_t batteryMv;
+    uint16_t reserved;
+};
+
+static_assert(sizeof(QueuedReading) == 12, "unexpected queued reading size");
 
 static WiFiClient wifiClient;
 static PubSubClient mqttClient(wifiClient);
-static std::atomic<bool> mqttBusy{false};
+// Owner of mqttClient: the interactive session task or a one-shot publish
+static std::mutex clientMutex;
+static std::atomic<bool> sessionRunning{false};
+static std::atomic<bool> sessionStop{false};
+
+// Inbound commands: actions for the main loop, plus work for the client owner after loop()
+static std::atomic<uint32_t> pendingCommands{0};
+static bool clearCommandTopic = false; // guarded by clientMutex
+static bool dumpPerf = false;          // guarded by clientMutex
+static uint32_t subscribedMs = 0;
+
+static void onMessage(char *topic, byte *payload, unsigned int length);
+
+static RTC_DATA_ATTR QueuedReading rtcQueue[MQTT_RTC_QUEUE_LEN];
+static RTC_DATA_ATTR uint8_t rtcQueueCount = 0;
+// Spill file entries already published. Kept here rather than in the file, so the file is
+// only ever appended to; after a power loss the whole file is replayed (readings carry ts).
+static RTC_DATA_ATTR uint32_t spillReadPos = 0;
+// Hash of everything the retained discovery configs depend on, as last published
+static RTC_DATA_ATTR uint32_t discoveryHash = 0;
+
+// Last reading that passed the report-on-change filter
+struct ReportState
+{
+    uint32_t epoch; // 0 = none yet
+    int16_t tempCenti;
+    uint16_t humCenti;
+};
+static RTC_DATA_ATTR ReportState lastReport = {0, 0, 0};
+static std::mutex queueMutex;
 
 void setupMQTT()
 {
     const auto cfg = ConfigManager::instance().getConfig();
     mqttClient.setServer(cfg.mqtt_host, cfg.mqtt_port);
+    // Room for the diagnostics payload (default PubSubClient buffer is 256 bytes)
+    mqttClient.setBufferSize(1024);
+    mqttClient.setCallback(onMessage);
+    wifiClient.setTimeout(MQTT_SOCKET_TIMEOUT_S);
+    mqttClient.setSocketTimeout(MQTT_SOCKET_TIMEOUT_S);
+}
+
+static String commandTopic(const AppConfig &cfg)
+{
+    return String(cfg.mqtt_topic) + "/cmd";
+}
+
+static void publishDiscovery(const AppConfig &cfg);
+
+static bool connectBroker(const AppConfig &cfg)
+{
+    mqttClient.setServer(cfg.mqtt_host, cfg.mqtt_port);
+
+    String clientId = String(cfg.device_name);
+    if (clientId.isEmpty())
+        clientId = String("EPDClock-") + String((uint32_t)ESP.getEfuseMac(), HEX);
+
+    DEBUG_PRINTF("[MQTT] Connecting to %s:%d as %s\n",
+                 cfg.mqtt_host, cfg.mqtt_port, clientId.c_str());
+
+    bool connected = false;
+    if (strlen(cfg.mqtt_user) == 0)
+        connected = mqttClient.connect(clientId.c_str());
+    else
+        connected = mqttClient.connect(clientId.c_str(), cfg.mqtt_user, cfg.mqtt_pass);
+
+    if (!connected)
+    {
+        DEBUG_PRINTF("[MQTT] Connection failed, state=%d\n", mqttClient.state());
+        return false;
+    }
+
+    // Retained commands are delivered right after the subscription
+    if (strlen(cfg.mqtt_topic) > 0 && !mqttClient.subscribe(commandTopic(cfg).c_str(), 1))
+        DEBUG_PRINT("[MQTT][ERR] Command subscription failed.");
+    subscribedMs = millis();
+    publishDiscovery(cfg);
+    return true;
+}
+
+// ---------- Home Assistant discovery ----------
+
+static void discoveryNodeId(char *out, size_t cap)
+{
+    snprintf(out, cap, "epdclock_%012llx", (unsigned long long)ESP.getEfuseMac());
+}
+
+static uint32_t fnv1a(uint32_t h, const char *s)
+{
+    while (*s)
+    {
+        h ^= (uint8_t)*s++;
+        h *= 16777619UL;
+    }
+    // Separator, so ("ab","c") and ("a","bc") differ
+    return (h ^ 0xFF) * 16777619UL;
+}
+
+static uint32_t discoveryConfigHash(const AppConfig &cfg)
+{
+    char port[8];
+    snprintf(port, sizeof(port), "%u", (unsigned)cfg.mqtt_port);
+    uint32_t h = 2166136261UL ^ MQTT_DISCOVERY_VERSION;
+    h = fnv1a(h, cfg.mqtt_host);
+    h = fnv1a(h, port);
+    h = fnv1a(h, cfg.mqtt_topic);
+    h = fnv1a(h, cfg.device_name);
+    h = fnv1a(h, cfg.app_version);
+    return h ? h : 1; // 0 = never published
+}
+
+// Retained configs are only resent when they would change (new broker, topic, name or firmware),
+// so a normal wake sends just the state message
+static void publishDiscovery(const AppConfig &cfg)
+{
+    if (strlen(cfg.mqtt_topic) == 0)
+        return;
+    const uint32_t hash = discoveryConfigHash(cfg);
+    if (hash == discoveryHash)
+        return;
+
+    char nodeId[24];
+    discoveryNodeId(nodeId, sizeof(nodeId));
+    const MetricsDevice dev = {nodeId, cfg.device_name, cfg.mqtt_topic, cfg.app_version};
+
+    char topic[96];
+    char objectId[24];
+    char payload[512];
+    bool ok = true;
+    for (size_t i = 0; i < metricsDiscoveryCount() && ok; i++)
+    {
+        const size_t len = formatMetricsDiscovery(payload, sizeof(payload), i, dev, objectId, sizeof(objectId));
+        snprintf(topic, sizeof(topic), MQTT_DISCOVERY_PREFIX "/sensor/%s/%s/config", nodeId, objectId);
+        ok = len > 0 && mqttClient.publish(topic, (const uint8_t *)payload, len, true);
+    }
+
+    if (ok)
+        discoveryHash = hash;
+    DEBUG_PRINTF("[MQTT] Discovery configs %s (%u sensors)\n", ok ? "published" : "failed", (unsigned)metricsDiscoveryCount());
+}
+
+static void publishDiagnostics(const AppConfig &cfg)
+{
+#if PERF_ENABLED
+    // Wake-cycle phase histograms ride along in the same session
+    if (strlen(cfg.mqtt_topic) > 0)
+    {
+        String diagTopic = String(cfg.mqtt_topic) + "/diag";
+        String diag = perfToJson();
+        if (!mqttClient.publish(diagTopic.c_str(), diag.c_str()))
+            DEBUG_PRINT("[MQTT] Diagnostics publish failed.");
+    }
+#endif
+}
+
+static void endSession()
+{
+    mqttClient.loop();
+    delay(50);
+    mqttClient.disconnect();
+}
+
+// ---------- Inbound commands ----------
+
+// Runs inside mqttClient.loop(), i.e. with clientMutex held
+static void onMessage(char *topic, byte *payload, unsigned int length)
+{
+    // Empty payload: our own clear of a retained command
+    if (length == 0)
+        return;
+    DEBUG_PRINTF("[MQTT] Command on %s (%u bytes)\n", topic, length);
+    clearCommandTopic = true;
+
+    JsonDocument doc;
+    if (deserializeJson(doc, (const char *)payload, length) || !doc.is<JsonObject>())
+    {
+        DEBUG_PRINT("[MQTT][ERR] Command is not a JSON object, ignored.");
+        return;
+    }
+
+    // {"cmd":"..."} triggers an action; any other object is a configuration update
+    if (doc["cmd"].is<const char *>())
+    {
+        const char *cmd = doc["cmd"];
+        if (strcmp(cmd, "refresh") == 0)
+            pendingCommands.fetch_or(MQTT_CMD_REFRESH);
+        else if (strcmp(cmd, "read") == 0)
+            pendingCommands.fetch_or(MQTT_CMD_READ);
+        else if (strcmp(cmd, "perf") == 0)
+            dumpPerf = true;
+        else
+            DEBUG_PRINTF("[MQTT][ERR] Unknown command: %s\n", cmd);
+        return;
+    }
+
+    // Saved by the main loop when it handles MQTT_CMD_CONFIG
+    if (ConfigManager::instance().updateFromJson(String((const char *)payload, length), /*saveAsync=*/false))
+        pendingCommands.fetch_or(MQTT_CMD_CONFIG);
+}
+
+// Work queued by onMessage that needs the client (caller holds clientMutex)
+static void serviceCommands(const AppConfig &cfg)
+{
+    if (dumpPerf)
+    {
+        dumpPerf = false;
+        publishDiagnostics(cfg);
+    }
+    if (clearCommandTopic)
+    {
+        // Remove the retained command so it is applied only once
+        clearCommandTopic = false;
+        mqttClient.publish(commandTopic(cfg).c_str(), (const uint8_t *)"", 0, true);
+    }
+}
+
+// Give a retained command time to arrive after subscribing, then act on it
+static void pollCommands(const AppConfig &cfg)
+{
+    while (mqttClient.connected() && (uint32_t)(millis() - subscribedMs) < MQTT_CMD_WAIT_MS)
+    {
+        mqttClient.loop();
+        delay(10);
+    }
+    serviceCommands(cfg);
+}
+
+uint32_t mqttTakeCommands()
+{
+    return pendingCommands.exchange(0);
+}
+
+static int8_t currentRssi()
+{
+    // 0 (not associated) leaves the field out
+    const int32_t rssi = WiFi.RSSI();
+    return rssi == 0 ? 0 : (int8_t)constrain(rssi, -127, -1);
+}
+
+// Wait up to MQTT_CLIENT_WAIT_MS for the session task to release the client
+static bool lockClient(std::unique_lock<std::mutex> &lk)
+{
+    const uint32_t start = millis();
+    while (!lk.try_lock())
+    {
+        if ((uint32_t)(millis() - start) >= MQTT_CLIENT_WAIT_MS)
+            return false;
+        delay(5);
+    }
+    return true;
 }
 
 bool publishMQTT_reading(float temperatureC, float humidityPct, int batteryMv)
 {
-    bool expected = false;
-    if (!mqttBusy.compare_exchange_strong(expected, true))
+    std::unique_lock<std::mutex> lk(clientMutex, std::defer_lock);
+    if (!lockClient(lk))
     {
         DEBUG_PRINT("[MQTT] Busy - skipping publish");
         return false;
     }
 
-    bool ok = false;
     const auto cfg = ConfigManager::instance().getConfig();
 
     if (!cfg.mqtt_enabled)
     {
         DEBUG_PRINT("[MQTT] MQTT disabled, skipping publish.");
-        mqttBusy.store(false);
         return true;
     }
 
     if (WiFi.status() != WL_CONNECTED)
     {
         DEBUG_PRINT("[MQTT] Wi-Fi not connected!");
-        mqttBusy.store(false);
         return false;
     }
 
-    mqttClient.setServer(cfg.mqtt_host, cfg.mqtt_port);
+    PERF_SCOPE(PERF_MQTT_PUBLISH);
+    // Publish through the interactive session when it is up
+    const bool inSession = mqttClient.connected();
+    if (!inSession && !connectBroker(cfg))
+        return false;
 
-    String clientId = String(cfg.device_name);
-    if (clientId.isEmpty())
-        clientId = String("EPDClock-") + String((uint32_t)ESP.getEfuseMac(), HEX);
+    const MetricsRecord r = {metricsCenti(temperatureC), metricsCenti(humidityPct), batteryMv, 0, nullptr, nullptr, currentRssi()};
+    char payload[160];
+    formatMetricsJson(payload, sizeof(payload), r, METRICS_MQTT);
 
-    DEBUG_PRINTF("[MQTT] Connecting to %s:%d as %s\n",
-                 cfg.mqtt_host, cfg.mqtt_port, clientId.c_str());
+    DEBUG_PRINTF("[MQTT] Publish on %s: %s\n", cfg.mqtt_topic, payload);
 
-    bool connected = false;
-    if (strlen(cfg.mqtt_user) == 0)
-        connected = mqttClient.connect(clientId.c_str());
-    else
-        connected = mqttClient.connect(clientId.c_str(), cfg.mqtt_user, cfg.mqtt_pass);
+    const bool ok = mqttClient.publish(cfg.mqtt_topic, payload);
+    if (!inSession)
+    {
+        if (ok)
+            publishDiagnostics(cfg);
+        pollCommands(cfg);
+        endSession();
+    }
 
-    if (!connected)
+    DEBUG_PRINT(ok ? "[MQTT] Publish success!" : "[MQTT] Publish failed!");
+    return ok;
+}
+
+// ---------- Batched uploads with offline backlog ----------
+
+static int16_t toCenti(float v, float lo, float hi)
+{
+    if (v < lo)
+        v = lo;
+    if (v > hi)
+        v = hi;
+    return (int16_t)lroundf(v * 100.0f);
+}
+
+static bool publishQueued(const AppConfig &cfg, const QueuedReading &q)
+{
+    // RSSI is that of the publishing connection, not of the wake that took the reading
+    MetricsRecord r = {q.tempCenti, q.humCenti, q.batteryMv, 0, nullptr, nullptr, currentRssi()};
+    // Readings taken before the first NTP sync have no usable timestamp
+    if (q.epoch >= HISTORY_MIN_EPOCH)
+        r.epoch = q.epoch;
+    char payload[160];
+    formatMetricsJson(payload, sizeof(payload), r, METRICS_MQTT);
+    return mqttClient.publish(cfg.mqtt_topic, payload);
+}
+
+// Number of entries in the spill file (0 when missing); also clamps a read position
+// that does not belong to this file
+static uint32_t spillStoredCount()
+{
+    if (!LittleFS.exists(MQTT_SPILL_PATH))
     {
-        DEBUG_PRINTF("[MQTT] Connection failed, state=%d\n", mqttClient.state());
-        mqttBusy.store(false);
+        if (LittleFS.exists(MQTT_SPILL_LEGACY_PATH))
+            LittleFS.remove(MQTT_SPILL_LEGACY_PATH);
+        spillReadPos = 0;
+        return 0;
+    }
+    File f = LittleFS.open(MQTT_SPILL_PATH, "r");
+    const uint32_t stored = f ? f.size() / sizeof(QueuedReading) : 0;
+    if (spillReadPos > stored)
+        spillReadPos = 0;
+    return stored;
+}
+
+// Rewrite the spill file without its already-published prefix. Only needed when the broker
+// stayed away long enough for the oldest readings to be dropped (replay deletes the file).
+static bool compactSpill(uint32_t &stored)
+{
+    File src = LittleFS.open(MQTT_SPILL_PATH, "r");
+    File dst = LittleFS.open(MQTT_SPILL_PATH ".tmp", "w");
+    bool ok = src && dst && src.seek(spillReadPos * sizeof(QueuedReading), SeekSet);
+
+    QueuedReading chunk[MQTT_RTC_QUEUE_LEN];
+    while (ok)
+    {
+        const size_t got = src.read((uint8_t *)chunk, sizeof(chunk));
+        if (got == 0)
+            break;
+        ok = dst.write((const uint8_t *)chunk, got) == got;
+    }
+    src.close();
+    dst.close();
+
+    ok = ok && LittleFS.remove(MQTT_SPILL_PATH) && LittleFS.rename(MQTT_SPILL_PATH ".tmp", MQTT_SPILL_PATH);
+    if (!ok)
+    {
+        LittleFS.remove(MQTT_SPILL_PATH ".tmp");
         return false;
     }
+    stored -= spillReadPos;
+    spillReadPos = 0;
+    return true;
+}
 
-    char payload[256];
-    snprintf(payload, sizeof(payload),
-             "{\"temperature_c\":%.2f,\"humidity_pct\":%.2f,\"battery_mv\":%d}",
-             temperatureC, humidityPct, batteryMv);
+// Caller holds queueMutex
+static bool spillLocked()
+{
+    if (rtcQueueCount == 0)
+        return true;
+    if (!LittleFS.begin(false))
+    {
+        DEBUG_PRINT("[MQTT][ERR] LittleFS mount failed, backlog stays in RTC memory.");
+        return false;
+    }
 
-    DEBUG_PRINTF("[MQTT] Publish on %s: %s\n", cfg.mqtt_topic, payload);
+    uint32_t stored = spillStoredCount();
 
-    ok = mqttClient.publish(cfg.mqtt_topic, payload);
-    mqttClient.loop();
-    delay(50);
-    mqttClient.disconnect();
+    // Broker unreachable for a long time: drop the oldest readings, they remain in the local history
+    if (stored - spillReadPos + rtcQueueCount > MQTT_SPILL_MAX)
+        spillReadPos = stored + rtcQueueCount - MQTT_SPILL_MAX;
+    if (spillReadPos >= MQTT_SPILL_MAX && spillReadPos <= stored)
+        compactSpill(stored);
+
+    File f = LittleFS.open(MQTT_SPILL_PATH, "a");
+    const size_t bytes = sizeof(QueuedReading) * rtcQueueCount;
+    const bool ok = f && f.write((const uint8_t *)rtcQueue, bytes) == bytes;
+    f.close();
+    if (!ok)
+    {
+        DEBUG_PRINT("[MQTT][ERR] Backlog spill failed.");
+        return false;
+    }
 
-    mqttBusy.store(false);
+    DEBUG_PRINTF("[MQTT] Spilled %u readings to flash (%lu pending)\n",
+                 rtcQueueCount, (unsigned long)(stored + rtcQueueCount - spillReadPos));
+    rtcQueueCount = 0;
+    return true;
+}
 
-    DEBUG_PRINT(ok ? "[MQTT] Publish success!" : "[MQTT] Publish failed!");
+void queueMQTT_reading(uint32_t epoch, float temperatureC, float humidityPct, int batteryMv)
+{
+    std::lock_guard<std::mutex> lk(queueMutex);
+    if (rtcQueueCount >= MQTT_RTC_QUEUE_LEN && !spillLocked())
+    {
+        // No flash either: keep the newest readings
+        memmove(&rtcQueue[0], &rtcQueue[1], sizeof(QueuedReading) * (MQTT_RTC_QUEUE_LEN - 1));
+        rtcQueueCount = MQTT_RTC_QUEUE_LEN - 1;
+    }
+
+    QueuedReading &r = rtcQueue[rtcQueueCount++];
+    r.epoch = epoch;
+    r.tempCenti = toCenti(temperatureC, -300.0f, 300.0f);
+    r.humCenti = (uint16_t)toCenti(humidityPct, 0.0f, 100.0f);
+    r.batteryMv = (uint16_t)constrain(batteryMv, 0, 65535);
+    r.reserved = 0;
+}
+
+bool mqttShouldReport(const AppConfig &cfg, uint32_t epoch, float temperatureC, float humidityPct)
+{
+    const int16_t t = toCenti(temperatureC, -300.0f, 300.0f);
+    const uint16_t h = (uint16_t)toCenti(humidityPct, 0.0f, 100.0f);
+
+    // Without a reference or a valid clock there is nothing to compare against
+    bool report = lastReport.epoch == 0 || epoch < HISTORY_MIN_EPOCH || epoch < lastReport.epoch;
+    if (!report)
+    {
+        // Wakes are minute-aligned: half a minute of slack keeps the heartbeat on schedule
+        report = epoch - lastReport.epoch + 30 >= cfg.mqtt_max_silence_min * 60UL;
+        report = report || abs(t - lastReport.tempCenti) >= lroundf(cfg.mqtt_deadband_temp_c * 100.0f);
+        report = report || abs((int32_t)h - (int32_t)lastReport.humCenti) >= lroundf(cfg.mqtt_deadband_hum_pct * 100.0f);
+    }
+    if (report)
+        lastReport = {epoch, t, h};
+    return report;
+}
+
+bool spillMQTT_backlog()
+{
+    std::lock_guard<std::mutex> lk(queueMutex);
+    return spillLocked();
+}
+
+uint32_t queuedMQTT_count()
+{
+    std::lock_guard<std::mutex> lk(queueMutex);
+    const uint32_t stored = LittleFS.begin(false) ? spillStoredCount() : 0;
+    return rtcQueueCount + (stored - spillReadPos);
+}
+
+// Replay the flash backlog; returns false when a publish failed (remaining entries stay on flash)
+static bool replaySpill(const AppConfig &cfg, uint32_t &sent)
+{
+    if (!LittleFS.begin(false))
+        return true;
+    const uint32_t stored = spillStoredCount();
+    if (stored == 0)
+    {
+        LittleFS.remove(MQTT_SPILL_PATH);
+        return true;
+    }
+
+    File f = LittleFS.open(MQTT_SPILL_PATH, "r");
+    if (!f || !f.seek(spillReadPos * sizeof(QueuedReading), SeekSet))
+        return false;
+
+    bool ok = true;
+    QueuedReading chunk[MQTT_RTC_QUEUE_LEN];
+    while (ok && spillReadPos < stored && sent < MQTT_BATCH_MAX)
+    {
+        const uint32_t want = min<uint32_t>(MQTT_RTC_QUEUE_LEN, stored - spillReadPos);
+        const uint32_t got = f.read((uint8_t *)chunk, want * sizeof(QueuedReading)) / sizeof(QueuedReading);
+        if (got == 0)
+        {
+            ok = false;
+            break;
+        }
+        for (uint32_t i = 0; i < got && ok && sent < MQTT_BATCH_MAX; i++)
+        {
+            ok = publishQueued(cfg, chunk[i]);
+            if (ok)
+            {
+                spillReadPos++;
+                sent++;
+            }
+        }
+        mqttClient.loop();
+    }
+    f.close();
+
+    if (spillReadPos < stored)
+        return false;
+    LittleFS.remove(MQTT_SPILL_PATH);
+    spillReadPos = 0;
+    return ok;
+}
+
+// Publish queued readings over the connected client (caller holds clientMutex)
+static bool drainBacklog(const AppConfig &cfg, uint32_t &sent)
+{
+    std::lock_guard<std::mutex> lk(queueMutex);
+
+    // Oldest first: flash backlog, then the readings still in RTC memory
+    sent = 0;
+    bool ok = replaySpill(cfg, sent);
+
+    uint8_t done = 0;
+    while (ok && done < rtcQueueCount && sent < MQTT_BATCH_MAX)
+    {
+        ok = publishQueued(cfg, rtcQueue[done]);
+        if (ok)
+        {
+            done++;
+            sent++;
+        }
+    }
+    if (done > 0)
+    {
+        memmove(&rtcQueue[0], &rtcQueue[done], sizeof(QueuedReading) * (rtcQueueCount - done));
+        rtcQueueCount -= done;
+    }
+
+    DEBUG_PRINTF("[MQTT] Batch upload: %lu sent, %u still queued in RTC memory%s\n",
+                 (unsigned long)sent, rtcQueueCount, ok ? "" : " (publish failed)");
+    return ok && rtcQueueCount == 0;
+}
+
+bool publishMQTT_backlog()
+{
+    std::unique_lock<std::mutex> lk(clientMutex, std::defer_lock);
+    if (!lockClient(lk))
+    {
+        DEBUG_PRINT("[MQTT] Busy - skipping backlog upload");
+        return false;
+    }
+
+    const auto cfg = ConfigManager::instance().getConfig();
+    if (!cfg.mqtt_enabled || WiFi.status() != WL_CONNECTED)
+    {
+        DEBUG_PRINT("[MQTT] Backlog upload skipped (disabled or no Wi-Fi).");
+        return false;
+    }
+
+    PERF_SCOPE(PERF_MQTT_PUBLISH);
+    if (!connectBroker(cfg))
+        return false;
+
+    uint32_t sent = 0;
+    const bool ok = drainBacklog(cfg, sent);
+    if (sent > 0)
+        publishDiagnostics(cfg);
+    pollCommands(cfg);
+    endSession();
     return ok;
 }
+
+// ---------- Interactive session ----------
+
+static bool rtcQueuePending()
+{
+    std::lock_guard<std::mutex> lk(queueMutex);
+    return rtcQueueCount > 0;
+}
+
+static void sessionTask(void *)
+{
+    uint32_t backoffMs = MQTT_BACKOFF_MIN_MS;
+    uint32_t nextAttemptMs = millis();
+    // Task-local copy: a connect can outlast several publishes of the web server
+    AppConfig cfg;
+    uint32_t cfgGeneration = ConfigManager::instance().copySnapshot(cfg);
+    bool drainAll = true; // the spill file may hold readings from earlier wakes
+
+    while (!sessionStop.load())
+    {
+        vTaskDelay(pdMS_TO_TICKS(MQTT_SESSION_TICK_MS));
+
+        // A one-shot publish owns the client: service it next tick
+        std::unique_lock<std::mutex> lk(clientMutex, std::try_to_lock);
+        if (!lk.owns_lock())
+            continue;
+
+        if (ConfigManager::instance().generation() != cfgGeneration)
+        {
+            // Broker settings may have changed: reconnect with the new ones
+            cfgGeneration = ConfigManager::instance().copySnapshot(cfg);
+            if (mqttClient.connected())
+                mqttClient.disconnect();
+            backoffMs = MQTT_BACKOFF_MIN_MS;
+            nextAttemptMs = millis();
+        }
+
+        if (!cfg.mqtt_enabled || WiFi.status() != WL_CONNECTED)
+        {
+            if (mqttClient.connected())
+                mqttClient.disconnect();
+            continue;
+        }
+
+        if (!mqttClient.connected())
+        {
+            const uint32_t nowMs = millis();
+            if ((int32_t)(nowMs - nextAttemptMs) < 0)
+                continue;
+            if (!connectBroker(cfg))
+            {
+                DEBUG_PRINTF("[MQTT] Session retry in %lu s\n", (unsigned long)(backoffMs / 1000));
+                nextAttemptMs = nowMs + backoffMs;
+                backoffMs = min<uint32_t>(backoffMs * 2, MQTT_BACKOFF_MAX_MS);
+                continue;
+            }
+            DEBUG_PRINT("[MQTT] Session connected.");
+            backoffMs = MQTT_BACKOFF_MIN_MS;
+            drainAll = true;
+        }
+
+        mqttClient.loop();
+        serviceCommands(cfg);
+
+        if (drainAll || rtcQueuePending())
+        {
+            PERF_SCOPE(PERF_MQTT_PUBLISH);
+            uint32_t sent = 0;
+            const bool wasDrainAll = drainAll;
+            // More than one batch pending, or a failed publish: continue next tick
+            drainAll = !drainBacklog(cfg, sent);
+            if (wasDrainAll && sent > 0)
+                publishDiagnostics(cfg);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lk(clientMutex);
+        if (mqttClient.connected())
+            endSession();
+    }
+    DEBUG_PRINT("[MQTT] Session closed.");
+    sessionRunning.store(false);
+    vTaskDelete(nullptr);
+}
+
+void mqttSessionStart()
+{
+    bool expected = false;
+    if (!sessionRunning.compare_exchange_strong(expected, true))
+        return;
+    sessionStop.store(false);
+    if (xTaskCreate(sessionTask, "mqttSession", 6144, nullptr, 1, nullptr) != pdPASS)
+    {
+        DEBUG_PRINT("[MQTT][ERR] Session task creation failed.");
+        sessionRunning.store(false);
+    }
+}
+
+void mqttSessionStop()
+{
+    if (!sessionRunning.load())
+        return;
+    sessionStop.store(true);
+    const uint32_t start = millis();
+    while (sessionRunning.load() && (uint32_t)(millis() - start) < MQTT_SESSION_STOP_MS)
+        delay(10);
+    // Still blocked in a connect (slow DNS): it fails once Wi-Fi goes down, and the client
+    // stays locked by the task until then
+    if (sessionRunning.load())
+        DEBUG_PRINTF("[MQTT][ERR] Session task did not stop within %u ms.\n", MQTT_SESSION_STOP_MS);
+}
@@ -1,5 +1,45 @@
 #pragma once
 #include <Arduino.h>
 
+struct AppConfig;
+
+// Offline backlog: readings wait in RTC memory and spill to LittleFS when it fills up
+#define MQTT_RTC_QUEUE_LEN 16
+#define MQTT_SPILL_PATH "/mqtt_backlog.bin" // append-only QueuedReading entries
+#define MQTT_SPILL_LEGACY_PATH "/mqtt_q.bin"  // earlier format with an in-file header, removed
+#define MQTT_SPILL_MAX 2880   // readings kept on flash (~2 days at one per minute), oldest dropped first
+#define MQTT_BATCH_MAX 240    // readings published per broker session, the rest waits for the next one
+
 void setupMQTT();
 bool publishMQTT_reading(float temperatureC, float humidityPct, int batteryMv);
+
+// Queue one reading for the next batched upload (no network access)
+void queueMQTT_reading(uint32_t epoch, float temperatureC, float humidityPct, int batteryMv);
+// Report on change: true when the reading moved beyond the configured deadbands since the
+// last reported one (or mqtt_max_silence_min elapsed); it then becomes the new reference
+bool mqttShouldReport(const AppConfig &cfg, uint32_t epoch, float temperatureC, float humidityPct);
+// Publish queued readings oldest first, with their original timestamps, in one broker session
+bool publishMQTT_backlog();
+// Move readings queued in RTC memory to flash (before RTC memory is lost)
+bool spillMQTT_backlog();
+uint32_t queuedMQTT_count();
+
+// Commands received on <topic>/cmd that the main loop has to carry out.
+// Payload {"cmd":"refresh"|"read"|"perf"} or a configuration object (same schema as /api/config);
+// "perf" and configuration updates are handled inside the MQTT module. Retained commands are
+// picked up at the next connect and cleared once applied.
+enum MqttCommand : uint32_t
+{
+    MQTT_CMD_REFRESH = 1 << 0, // full display refresh
+    MQTT_CMD_READ = 1 << 1,    // take and publish a reading now
+    MQTT_CMD_CONFIG = 1 << 2   // configuration was changed (already applied in memory)
+};
+
+// Pending MqttCommand bits, cleared by the call
+uint32_t mqttTakeCommands();
+
+// Interactive mode: a background task keeps one broker session open while Wi-Fi is up
+// (reconnecting with backoff) and publishes readings as soon as they are queued
+void mqttSessionStart();
+// Close the session and end the task (before Wi-Fi goes down or the device sleeps)
+void mqttSessionStop();
@@ -0,0 +1,196 @@
+#include "perf.h"
+#include <atomic>
+
+// Heap allocation counter. platformio.ini links with -Wl,--wrap=malloc/calloc/realloc,
+// so the wrappers must exist even when the timers are compiled out.
+// Only the task inside a PerfAllocScope is counted: Wi-Fi, the web server or the refresh task
+// allocating at the same time on the other core would otherwise show up in its count.
+static std::atomic<uint32_t> allocCount{0};
+static std::atomic<TaskHandle_t> allocTask{nullptr};
+
+static inline void IRAM_ATTR countAlloc()
+{
+    const TaskHandle_t task = allocTask.load(std::memory_order_relaxed);
+    if (task && task == xTaskGetCurrentTaskHandle())
+        allocCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+// The wrappers sit in front of every allocation in the image and, like the IDF heap functions
+// they wrap, stay in IRAM: they must be callable while the flash cache is disabled.
+extern "C"
+{
+    void *__real_malloc(size_t size);
+    void *__real_calloc(size_t n, size_t size);
+    void *__real_realloc(void *ptr, size_t size);
+
+    void *IRAM_ATTR __wrap_malloc(size_t size)
+    {
+        countAlloc();
+        return __real_malloc(size);
+    }
+
+    void *IRAM_ATTR __wrap_calloc(size_t n, size_t size)
+    {
+        countAlloc();
+        return __real_calloc(n, size);
+    }
+
+    void *IRAM_ATTR __wrap_realloc(void *ptr, size_t size)
+    {
+        countAlloc();
+        return __real_realloc(ptr, size);
+    }
+}
+
+#if PERF_ENABLED
+#include <ArduinoJson.h>
+
+// Two buckets per power of two, starting at 64 us: upper range is ~4 s
+#define PERF_BUCKETS 32
+#define PERF_MIN_OCTAVE 6
+
+struct PerfStats
+{
+    uint32_t count;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint64_t sumUs;
+    uint16_t buckets[PERF_BUCKETS];
+};
+
+static RTC_DATA_ATTR PerfStats perfStats[PERF_PHASE_COUNT];
+static RTC_DATA_ATTR uint32_t perfCounters[PERF_COUNTER_COUNT];
+static portMUX_TYPE perfMux = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *const PERF_PHASE_NAMES[PERF_PHASE_COUNT] = {
+    "wake_total", "sensor_read", "battery_read", "epd_render",
+    "epd_refresh", "epd_join", "epd_busy", "wifi_connect", "ntp_sync", "mqtt_publish"};
+
+static const char *const PERF_COUNTER_NAMES[PERF_COUNTER_COUNT] = {
+    "wifi_fast_ok", "wifi_fast_fallback", "text_allocs"};
+
+static uint8_t bucketIndex(uint32_t us)
+{
+    if (us < (1UL << PERF_MIN_OCTAVE))
+        return 0;
+    const int octave = 31 - __builtin_clz(us);
+    const int half = (us >> (octave - 1)) & 1;
+    const int idx = (octave - PERF_MIN_OCTAVE) * 2 + half;
+    return (idx >= PERF_BUCKETS) ? PERF_BUCKETS - 1 : (uint8_t)idx;
+}
+
+static uint32_t bucketUpperUs(uint8_t idx)
+{
+    const uint32_t base = 1UL << (PERF_MIN_OCTAVE + idx / 2);
+    return (idx & 1) ? base * 2 : base + base / 2;
+}
+
+void perfRecord(PerfPhase phase, uint32_t us)
+{
+    if (phase >= PERF_PHASE_COUNT)
+        return;
+
+    portENTER_CRITICAL(&perfMux);
+    PerfStats &s = perfStats[phase];
+    if (s.count == 0 || us < s.minUs)
+        s.minUs = us;
+    if (us > s.maxUs)
+        s.maxUs = us;
+    s.count++;
+    s.sumUs += us;
+
+    uint16_t &bucket = s.buckets[bucketIndex(us)];
+    if (bucket == UINT16_MAX)
+    {
+        // Halve the histogram instead of saturating so percentiles keep tracking recent wakes
+        for (int i = 0; i < PERF_BUCKETS; i++)
+            s.buckets[i] >>= 1;
+    }
+    bucket++;
+    portEXIT_CRITICAL(&perfMux);
+}
+
+void perfCount(PerfCounter counter, uint32_t n)
+{
+    if (counter >= PERF_COUNTER_COUNT)
+        return;
+    portENTER_CRITICAL(&perfMux);
+    perfCounters[counter] += n;
+    portEXIT_CRITICAL(&perfMux);
+}
+
+uint32_t perfAllocations()
+{
+    return allocCount.load(std::memory_order_relaxed);
+}
+
+TaskHandle_t perfAllocTrack(TaskHandle_t task)
+{
+    return allocTask.exchange(task, std::memory_order_relaxed);
+}
+
+void perfReset()
+{
+    portENTER_CRITICAL(&perfMux);
+    memset(perfStats, 0, sizeof(perfStats));
+    memset(perfCounters, 0, sizeof(perfCounters));
+    portEXIT_CRITICAL(&perfMux);
+}
+
+static uint32_t percentileUs(const PerfStats &s, uint8_t pct)
+{
+    uint32_t total = 0;
+    for (int i = 0; i < PERF_BUCKETS; i++)
+        total += s.buckets[i];
+    if (total == 0)
+        return 0;
+
+    const uint32_t target = (total * pct + 99) / 100;
+    uint32_t seen = 0;
+    for (int i = 0; i < PERF_BUCKETS; i++)
+    {
+        seen += s.buckets[i];
+        if (seen >= target)
+        {
+            const uint32_t upper = bucketUpperUs(i);
+            return (upper < s.maxUs) ? upper : s.maxUs;
+        }
+    }
+    return s.maxUs;
+}
+
+String perfToJson()
+{
+    PerfStats snapshot[PERF_PHASE_COUNT];
+    uint32_t counters[PERF_COUNTER_COUNT];
+    portENTER_CRITICAL(&perfMux);
+    memcpy(snapshot, perfStats, sizeof(snapshot));
+    memcpy(counters, perfCounters, sizeof(counters));
+    portEXIT_CRITICAL(&perfMux);
+
+    JsonDocument doc;
+    doc["enabled"] = true;
+    doc["wakes"] = snapshot[PERF_WAKE_TOTAL].count;
+    JsonObject phases = doc["phases"].to<JsonObject>();
+    for (int i = 0; i < PERF_PHASE_COUNT; i++)
+    {
+        const PerfStats &s = snapshot[i];
+        JsonObject o = phases[PERF_PHASE_NAMES[i]].to<JsonObject>();
+        o["n"] = s.count;
+        if (s.count == 0)
+            continue;
+        o["min_us"] = s.minUs;
+        o["avg_us"] = (uint32_t)(s.sumUs / s.count);
+        o["max_us"] = s.maxUs;
+        o["p95_us"] = percentileUs(s, 95);
+    }
+    JsonObject counts = doc["counters"].to<JsonObject>();
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++)
+        counts[PERF_COUNTER_NAMES[i]] = counters[i];
+
+    String out;
+    serializeJson(doc, out);
+    return out;
+}
+
+#endif
@@ -0,0 +1,96 @@
+#pragma once
+#include <Arduino.h>
+
+// Wake-cycle phase timers. Histograms live in RTC memory and accumulate across deep sleep.
+// Build with -DPERF_ENABLED=0 to compile every timer out.
+#ifndef PERF_ENABLED
+#define PERF_ENABLED 1
+#endif
+
+enum PerfPhase : uint8_t
+{
+    PERF_WAKE_TOTAL,    // timer wake: boot -> deep sleep request
+    PERF_SENSOR_READ,   // SHTC3 over I2C
+    PERF_BATTERY_READ,  // ADC battery voltage
+    PERF_EPD_RENDER,    // clock face into the offscreen frame
+    PERF_EPD_REFRESH,   // panel init + SPI transfer + waveform (runs in the background)
+    PERF_EPD_JOIN,      // time spent waiting for that background refresh to finish
+    PERF_EPD_BUSY,      // refresh task blocked on the BUSY edge interrupt (core idle)
+    PERF_WIFI_CONNECT,  // STA association + DHCP
+    PERF_NTP_SYNC,      // SNTP time sync
+    PERF_MQTT_PUBLISH,  // broker connect + publish
+    PERF_PHASE_COUNT
+};
+
+// Event counters kept next to the histograms
+enum PerfCounter : uint8_t
+{
+    PERF_WIFI_FAST_OK,       // directed connect from the RTC cache succeeded
+    PERF_WIFI_FAST_FALLBACK, // cached connect failed, full scan + DHCP used
+    PERF_TEXT_ALLOCS,        // heap allocations while formatting readings / rendering the frame (expected 0)
+    PERF_COUNTER_COUNT
+};
+
+#if PERF_ENABLED
+
+void perfRecord(PerfPhase phase, uint32_t us);
+void perfCount(PerfCounter counter, uint32_t n = 1);
+// malloc/calloc/realloc calls made by the tracked task since boot (counted by the
+// -Wl,--wrap wrappers in perf.cpp)
+uint32_t perfAllocations();
+// Count the allocations of task from now on (nullptr = none); returns the previously tracked task.
+// One task at a time: a PerfAllocScope on another task takes the tracking over until it ends.
+TaskHandle_t perfAllocTrack(TaskHandle_t task);
+void perfReset();
+// JSON object with per-phase n/min/avg/max/p95 (microseconds)
+String perfToJson();
+
+// Records the lifetime of the enclosing scope into a phase histogram
+class PerfScope
+{
+public:
+    explicit PerfScope(PerfPhase phase) : phase_(phase), startUs_(micros()) {}
+    ~PerfScope() { perfRecord(phase_, micros() - startUs_); }
+
+private:
+    PerfPhase phase_;
+    uint32_t startUs_;
+};
+
+#define PERF_CONCAT_(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_(a, b)
+#define PERF_SCOPE(phase) PerfScope PERF_CONCAT(perfScope_, __LINE__)(phase)
+
+// Adds the heap allocations made by the current task in the enclosing scope to a counter
+class PerfAllocScope
+{
+public:
+    explicit PerfAllocScope(PerfCounter counter)
+        : counter_(counter), prevTask_(perfAllocTrack(xTaskGetCurrentTaskHandle())), start_(perfAllocations()) {}
+    ~PerfAllocScope()
+    {
+        const uint32_t n = perfAllocations() - start_;
+        perfAllocTrack(prevTask_);
+        if (n)
+            perfCount(counter_, n);
+    }
+
+private:
+    PerfCounter counter_;
+    TaskHandle_t prevTask_;
+    uint32_t start_;
+};
+
+#define PERF_ALLOC_SCOPE(counter) PerfAllocScope PERF_CONCAT(perfAllocScope_, __LINE__)(counter)
+
+#else
+
+inline void perfRecord(PerfPhase, uint32_t) {}
+inline void perfCount(PerfCounter, uint32_t = 1) {}
+inline uint32_t perfAllocations() { return 0; }
+inline void perfReset() {}
+inline String perfToJson() { return String("{\"enabled\":false}"); }
+#define PERF_SCOPE(phase) ((void)0)
+#define PERF_ALLOC_SCOPE(counter) ((void)0)
+
+#endif
@@ -0,0 +1,73 @@
+#include "sensor_filter.h"
+
+struct EmaState
+{
+    float value;
+    uint32_t epoch;
+    bool valid;
+};
+
+static RTC_DATA_ATTR EmaState emaState[SENSOR_CHANNELS];
+
+FilterBounds filterBounds(SensorChannel ch)
+{
+    static const FilterBounds bounds[SENSOR_CHANNELS] = {
+        {-40.0f, 125.0f}, // SHTC3 operating range
+        {0.0f, 100.0f},
+        {1000.0f, 6000.0f}, // divider doubles the ADC range; below 1 V there is no cell
+    };
+    return bounds[ch];
+}
+
+float filterMedian(float *samples, size_t n, const FilterBounds &bounds)
+{
+    // Compact the valid samples to the front
+    size_t valid = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        const float v = samples[i];
+        if (!isnan(v) && v >= bounds.minValid && v <= bounds.maxValid)
+            samples[valid++] = v;
+    }
+    if (valid == 0)
+        return NAN;
+
+    // Insertion sort: at most FILTER_MAX_SAMPLES values
+    for (size_t i = 1; i < valid; i++)
+    {
+        const float v = samples[i];
+        size_t j = i;
+        while (j > 0 && samples[j - 1] > v)
+        {
+            samples[j] = samples[j - 1];
+            j--;
+        }
+        samples[j] = v;
+    }
+    const size_t mid = valid / 2;
+    return (valid & 1) ? samples[mid] : 0.5f * (samples[mid - 1] + samples[mid]);
+}
+
+void filterReset()
+{
+    memset(emaState, 0, sizeof(emaState));
+}
+
+float filterSmooth(SensorChannel ch, float value, float alpha, uint32_t epoch)
+{
+    EmaState &s = emaState[ch];
+    if (isnan(value))
+        return s.valid ? s.value : NAN;
+
+    if (alpha <= 0.0f || alpha > 1.0f)
+        alpha = 1.0f;
+    const bool gap = epoch && s.epoch && (epoch < s.epoch || epoch - s.epoch > FILTER_EMA_RESET_S);
+    if (!s.valid || gap)
+        s.value = value;
+    else
+        s.value += alpha * (value - s.value);
+    s.valid = true;
+    if (epoch)
+        s.epoch = epoch;
+    return s.value;
+}
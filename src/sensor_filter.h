@@ -0,0 +1,36 @@
+#pragma once
+#include <Arduino.h>
+
+// Oversampling pipeline for the measured channels: a burst of samples is reduced to
+// its median after dropping values outside the channel's plausible range, then
+// smoothed by an exponential moving average whose state survives deep sleep (RTC).
+
+#define FILTER_MAX_SAMPLES 15
+#define FILTER_EMA_RESET_S (30UL * 60UL) // a longer gap (power off, long interactive session) reseeds the average
+
+enum SensorChannel : uint8_t
+{
+    SENSOR_TEMP,     // degC
+    SENSOR_HUMIDITY, // %RH
+    SENSOR_BATTERY,  // mV
+    SENSOR_CHANNELS
+};
+
+struct FilterBounds
+{
+    float minValid;
+    float maxValid;
+};
+
+// Plausible range of each channel (sensor limits); samples outside are outliers
+FilterBounds filterBounds(SensorChannel ch);
+
+// Median of the in-range samples, NAN when none is left. Reorders samples.
+float filterMedian(float *samples, size_t n, const FilterBounds &bounds);
+
+// One EMA step (alpha 1 = no smoothing). A NAN value keeps the previous average.
+// epoch is used to detect long gaps; pass 0 when the clock is not valid.
+float filterSmooth(SensorChannel ch, float value, float alpha, uint32_t epoch);
+
+// Forget every average; the next filterSmooth() call of each channel reseeds it
+void filterReset();
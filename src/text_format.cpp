@@ -0,0 +1,53 @@
+#include "text_format.h"
+
+size_t formatUint(char *out, size_t cap, uint32_t v, uint8_t minDigits)
+{
+    if (cap == 0)
+        return 0;
+    char digits[10];
+    size_t n = 0;
+    do
+    {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v != 0 && n < sizeof(digits));
+    while (n < minDigits && n < sizeof(digits))
+        digits[n++] = '0';
+
+    size_t len = 0;
+    while (n > 0 && len + 1 < cap)
+        out[len++] = digits[--n];
+    out[len] = '\0';
+    return len;
+}
+
+size_t formatFixed(char *out, size_t cap, float v, uint8_t decimals)
+{
+    if (cap == 0)
+        return 0;
+    static const uint32_t scales[] = {1, 10, 100, 1000};
+    if (decimals > 3)
+        decimals = 3;
+    const uint32_t scale = scales[decimals];
+    // No reading (NaN) or nothing that fits the fixed-point range: the display shows "--"
+    if (!(fabsf(v) * (float)scale < 2.0e9f))
+    {
+        strlcpy(out, "--", cap);
+        return strlen(out);
+    }
+    // Fixed point, rounded half away from zero like dtostrf
+    const int32_t scaled = (int32_t)lroundf(v * (float)scale);
+    const uint32_t mag = (scaled < 0) ? (uint32_t)(-scaled) : (uint32_t)scaled;
+
+    size_t len = 0;
+    if (scaled < 0 && len + 1 < cap)
+        out[len++] = '-';
+    len += formatUint(out + len, cap - len, mag / scale);
+    if (decimals > 0 && len + 1 < cap)
+    {
+        out[len++] = '.';
+        len += formatUint(out + len, cap - len, mag % scale, decimals);
+    }
+    out[len] = '\0';
+    return len;
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include <Arduino.h>
+
+// Allocation-free formatting for the display/text path (no Wi-Fi or board dependencies).
+// Each returns the length written; output is always NUL-terminated (truncated to cap).
+size_t formatUint(char *out, size_t cap, uint32_t v, uint8_t minDigits = 1);
+// NaN, infinities and values beyond the int32 fixed-point range are written as "--"
+size_t formatFixed(char *out, size_t cap, float v, uint8_t decimals);
@@ -1,38 +1,82 @@
 #include "utils.h"
 #include "config.h"
 #include "config_manager.h"
+#include "perf.h"
 #include <WiFi.h>
+#include <atomic>
+#include <freertos/event_groups.h>
 
-// Simple circular log buffer
-static const int LOG_LINES = 200;
-static String logLines[LOG_LINES];
-static int logIndex = 0;
-static int logCount = 0;
+#define WIFI_CACHE_MAGIC 0x57464331UL
+#define WIFI_FAST_TIMEOUT_MS 1500        // directed connect budget before falling back to a full scan
+#define WIFI_LEASE_REUSE_S (6UL * 3600UL) // reuse the cached DHCP lease as static config for this long
 
-void appendLog(const char *msg)
+// Last successful association, kept across deep sleep for a directed reconnect
+struct WifiCache
 {
-    // store timestamp + message
-    char buf[256];
-    unsigned long ms = millis();
-    int n = snprintf(buf, sizeof(buf), "[%lu] %s", ms, msg);
-    logLines[logIndex] = String(buf);
-    logIndex = (logIndex + 1) % LOG_LINES;
-    if (logCount < LOG_LINES) logCount++;
+    uint32_t magic;
+    uint32_t key; // hash of SSID + password, invalidates the cache when credentials change
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint8_t reserved;
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns1;
+    uint32_t dns2;
+    uint32_t leaseEpoch; // time the lease was obtained from DHCP
+};
+
+static RTC_DATA_ATTR WifiCache wifiCache;
+
+// Background connect started by connectWiFiAsync()
+#define WIFI_ASYNC_DONE_BIT BIT0
+static EventGroupHandle_t wifiAsyncEvents = nullptr;
+static std::atomic<bool> wifiAsyncPending{false};
+static std::atomic<bool> wifiAsyncResult{false};
+static uint32_t wifiAsyncTimeoutMs = 0;
+
+static uint32_t wifiCacheKey(const AppConfig &cfg)
+{
+    // FNV-1a over "ssid\0pass"
+    uint32_t h = 2166136261UL;
+    for (const char *p = cfg.wifi_ssid; *p; p++)
+        h = (h ^ (uint8_t)*p) * 16777619UL;
+    h *= 16777619UL;
+    for (const char *p = cfg.wifi_pass; *p; p++)
+        h = (h ^ (uint8_t)*p) * 16777619UL;
+    return h;
 }
 
-String getLogs()
+static bool waitConnected(uint32_t timeoutMs)
 {
-    String out = "";
-    int start = (logIndex - logCount + LOG_LINES) % LOG_LINES;
-    for (int i = 0; i < logCount; i++) {
-        int idx = (start + i) % LOG_LINES;
-        out += logLines[idx];
-        out += '\n';
+    uint32_t t0 = millis();
+    while (millis() - t0 < timeoutMs)
+    {
+        if (WiFi.status() == WL_CONNECTED)
+            return true;
+        delay(20);
     }
-    return out;
+    return WiFi.status() == WL_CONNECTED;
 }
 
-bool connectWiFiShort(uint32_t timeoutMs)
+static void saveWifiCache(uint32_t key, uint32_t leaseEpoch)
+{
+    const uint8_t *bssid = WiFi.BSSID();
+    if (!bssid)
+        return;
+    wifiCache.key = key;
+    memcpy(wifiCache.bssid, bssid, sizeof(wifiCache.bssid));
+    wifiCache.channel = (uint8_t)WiFi.channel();
+    wifiCache.ip = (uint32_t)WiFi.localIP();
+    wifiCache.gateway = (uint32_t)WiFi.gatewayIP();
+    wifiCache.subnet = (uint32_t)WiFi.subnetMask();
+    wifiCache.dns1 = (uint32_t)WiFi.dnsIP(0);
+    wifiCache.dns2 = (uint32_t)WiFi.dnsIP(1);
+    wifiCache.leaseEpoch = leaseEpoch;
+    wifiCache.magic = WIFI_CACHE_MAGIC;
+}
+
+static bool connectStation(uint32_t timeoutMs)
 {
     if (WiFi.status() == WL_CONNECTED)
         return true;
@@ -44,31 +88,113 @@ bool connectWiFiShort(uint32_t timeoutMs)
         return false;
     }
 
+    PERF_SCOPE(PERF_WIFI_CONNECT);
+    // Credentials come from ConfigManager: skip the NVS write WiFi.begin() does by default
+    WiFi.persistent(false);
     WiFi.mode(WIFI_STA);
-    if (strlen(cfg.wifi_pass) == 0)
-        WiFi.begin(cfg.wifi_ssid);
-    else
-        WiFi.begin(cfg.wifi_ssid, cfg.wifi_pass);
+    const char *pass = strlen(cfg.wifi_pass) ? cfg.wifi_pass : nullptr;
+    const uint32_t key = wifiCacheKey(cfg);
+    const uint32_t now = (uint32_t)time(nullptr);
+    const uint32_t t0 = millis();
 
-    DEBUG_PRINTF("[WiFi] Connecting to '%s'...\n", cfg.wifi_ssid);
-
-    uint32_t t0 = millis();
-    while (millis() - t0 < timeoutMs)
+    if (wifiCache.magic == WIFI_CACHE_MAGIC && wifiCache.key == key)
     {
-        if (WiFi.status() == WL_CONNECTED)
+        // Directed connect: known BSSID/channel (no scan), previous lease as static config (no DHCP)
+        const bool reuseLease = wifiCache.ip != 0 && now >= wifiCache.leaseEpoch &&
+                                now - wifiCache.leaseEpoch < WIFI_LEASE_REUSE_S;
+        if (reuseLease)
+            WiFi.config(IPAddress(wifiCache.ip), IPAddress(wifiCache.gateway), IPAddress(wifiCache.subnet),
+                         IPAddress(wifiCache.dns1), IPAddress(wifiCache.dns2));
+        DEBUG_PRINTF("[WiFi] Fast connect to '%s' (ch %u%s)...\n",
+                     cfg.wifi_ssid, wifiCache.channel, reuseLease ? ", cached lease" : "");
+        WiFi.begin(cfg.wifi_ssid, pass, wifiCache.channel, wifiCache.bssid);
+
+        if (waitConnected(min<uint32_t>(timeoutMs, WIFI_FAST_TIMEOUT_MS)))
         {
-            DEBUG_PRINTF("[WiFi] Connected: %s\n", WiFi.localIP().toString().c_str());
+            perfCount(PERF_WIFI_FAST_OK);
+            saveWifiCache(key, reuseLease ? wifiCache.leaseEpoch : now);
+            DEBUG_PRINTF("[WiFi] Connected: %s (%lu ms)\n",
+                         WiFi.localIP().toString().c_str(), (unsigned long)(millis() - t0));
             return true;
         }
-        delay(200);
+
+        perfCount(PERF_WIFI_FAST_FALLBACK);
+        DEBUG_PRINT("[WiFi] Fast connect failed, falling back to scan + DHCP.");
+        wifiCache.magic = 0;
+        WiFi.disconnect();
+        if (reuseLease)
+            WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+    }
+
+    WiFi.begin(cfg.wifi_ssid, pass);
+    DEBUG_PRINTF("[WiFi] Connecting to '%s'...\n", cfg.wifi_ssid);
+
+    const uint32_t elapsed = millis() - t0;
+    if (elapsed < timeoutMs && waitConnected(timeoutMs - elapsed))
+    {
+        saveWifiCache(key, now);
+        DEBUG_PRINTF("[WiFi] Connected: %s (%lu ms)\n",
+                     WiFi.localIP().toString().c_str(), (unsigned long)(millis() - t0));
+        return true;
     }
 
     DEBUG_PRINT("[WiFi] Connection timeout.");
     return (WiFi.status() == WL_CONNECTED);
 }
 
+static void connectTask(void *)
+{
+    wifiAsyncResult.store(connectStation(wifiAsyncTimeoutMs));
+    xEventGroupSetBits(wifiAsyncEvents, WIFI_ASYNC_DONE_BIT);
+    vTaskDelete(nullptr);
+}
+
+// Wait for a background connect; false when none was started
+static bool awaitAsyncConnect(bool &connected)
+{
+    if (!wifiAsyncPending.load())
+        return false;
+    const uint32_t t0 = millis();
+    xEventGroupWaitBits(wifiAsyncEvents, WIFI_ASYNC_DONE_BIT, pdTRUE, pdTRUE, portMAX_DELAY);
+    wifiAsyncPending.store(false);
+    connected = wifiAsyncResult.load();
+    DEBUG_PRINTF("[WiFi] Background connect joined (waited %lu ms).\n", (unsigned long)(millis() - t0));
+    return true;
+}
+
+void connectWiFiAsync(uint32_t timeoutMs)
+{
+    if (wifiAsyncPending.load() || WiFi.status() == WL_CONNECTED)
+        return;
+    if (!wifiAsyncEvents)
+    {
+        wifiAsyncEvents = xEventGroupCreate();
+        if (!wifiAsyncEvents)
+            return;
+    }
+    xEventGroupClearBits(wifiAsyncEvents, WIFI_ASYNC_DONE_BIT);
+    wifiAsyncTimeoutMs = timeoutMs;
+    wifiAsyncPending.store(true);
+    // Core 0 runs the Wi-Fi stack; setup()/loop() keep core 1 for sensors and rendering
+    if (xTaskCreatePinnedToCore(connectTask, "wifiConnect", 6144, nullptr, 1, nullptr, 0) != pdPASS)
+    {
+        DEBUG_PRINT("[WiFi][ERR] Connect task creation failed, will connect on demand.");
+        wifiAsyncPending.store(false);
+    }
+}
+
+bool connectWiFiShort(uint32_t timeoutMs)
+{
+    bool connected = false;
+    if (awaitAsyncConnect(connected))
+        return connected;
+    return connectStation(timeoutMs);
+}
+
 void disconnectWiFiClean()
 {
+    bool connected = false;
+    awaitAsyncConnect(connected);
     if (WiFi.status() == WL_CONNECTED)
     {
         DEBUG_PRINT("[WiFi] Clean disconnect...");
@@ -78,6 +204,21 @@ void disconnectWiFiClean()
     }
 }
 
+size_t formatIp(char *out, size_t cap, const IPAddress &ip)
+{
+    if (cap == 0)
+        return 0;
+    size_t len = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        if (i > 0 && len + 1 < cap)
+            out[len++] = '.';
+        len += formatUint(out + len, cap - len, ip[i]);
+    }
+    out[len] = '\0';
+    return len;
+}
+
 static inline bool modeIsAp(wifi_mode_t mode)
 {
     return (mode == WIFI_MODE_AP || mode == WIFI_MODE_APSTA
@@ -1,13 +1,19 @@
 #pragma once
 #include <Arduino.h>
+#include "text_format.h"
 
 bool connectWiFiShort(uint32_t timeoutMs = 8000);
 void disconnectWiFiClean();
+// Start the STA connection on a background task (core 0) and return at once.
+// connectWiFiShort() and disconnectWiFiClean() wait for it to finish first.
+void connectWiFiAsync(uint32_t timeoutMs = 8000);
 
 bool isApModeActive();
 
-// Simple in-memory log buffer (for web UI)
-void appendLog(const char *msg);
-String getLogs();
-// Return latest metrics as a JSON object string (without enclosing braces)
-String getLatestMetricsJson();
+// Dotted quad, same conventions as the formatters in text_format.h
+size_t formatIp(char *out, size_t cap, const IPAddress &ip);
+
+// Latest metrics as a JSON object into out; returns the length (0 if it did not fit)
+size_t formatLatestMetricsJson(char *out, size_t cap);
+// Latest reading as shown on the face; false while there is no valid one
+bool latestReading(float &tempC, float &humidityPct, int &batteryMv);
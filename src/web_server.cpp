@@ -3,13 +3,25 @@
 #include "config_manager.h"
 #include "utils.h"
 #include "mqtt.h"
+#include "epd_frame.h"
+#include "perf.h"
+#include "history.h"
 
 #include <ESPAsyncWebServer.h>
 #include <LittleFS.h>
 #include <WiFi.h>
+#include <memory>
 
 static AsyncWebServer server(80);
 
+// Push channel for the web UI: "metrics" after each reading, "log" as lines are appended.
+// Log event ids are log cursors, so a reconnecting browser resumes from Last-Event-ID.
+static AsyncEventSource events("/api/events");
+static std::atomic<uint32_t> eventsLogCursor{0};
+static std::atomic<bool> webServerStarted{false};
+static std::atomic<bool> configApplyPending{false};
+static const uint32_t EVENTS_PUSH_INTERVAL_MS = 250;
+
 // Non-blocking Wi-Fi scan state to avoid starving AsyncTCP/task watchdog
 static bool wifiScanRunning = false;
 static uint32_t wifiScanStartedMs = 0;
@@ -89,10 +101,218 @@ static String buildWifiScanResponse(bool inProgress)
     return json;
 }
 
+// Chunked log response: prefix, log lines from a cursor, then (JSON) the cursor to poll with next
+struct LogStream
+{
+    char prefix[192] = "";
+    size_t prefixLen = 0;
+    size_t prefixSent = 0;
+    uint32_t cursor = 0;
+    uint32_t end = 0;
+    LogEncoding enc = LOG_TEXT;
+    uint8_t stage = 0;
+    char suffix[40] = "";
+    size_t suffixLen = 0;
+    size_t suffixSent = 0;
+};
+
+static size_t copyPending(uint8_t *buffer, size_t maxLen, const char *src, size_t len, size_t &sent)
+{
+    const size_t n = min(maxLen, len - sent);
+    memcpy(buffer, src + sent, n);
+    sent += n;
+    return n;
+}
+
+static AsyncWebServerResponse *beginLogStream(AsyncWebServerRequest *request, const char *prefix, uint32_t since, LogEncoding enc)
+{
+    std::shared_ptr<LogStream> st = std::make_shared<LogStream>();
+    st->prefixLen = strlcpy(st->prefix, prefix, sizeof(st->prefix));
+    if (st->prefixLen >= sizeof(st->prefix))
+        st->prefixLen = sizeof(st->prefix) - 1;
+    st->cursor = since;
+    st->end = logHead(); // lines logged while streaming wait for the next poll
+    st->enc = enc;
+    const char *type = (enc == LOG_JSON) ? "application/json; charset=utf-8" : "text/plain; charset=utf-8";
+    return request->beginChunkedResponse(type, [st](uint8_t *buffer, size_t maxLen, size_t index) -> size_t
+                                         {
+        if (st->stage == 0)
+        {
+            if (st->prefixSent < st->prefixLen)
+                return copyPending(buffer, maxLen, st->prefix, st->prefixLen, st->prefixSent);
+            st->stage = 1;
+        }
+        if (st->stage == 1)
+        {
+            // logFormat NUL-terminates, the terminator is not sent
+            const size_t n = logFormat(st->cursor, st->end, (char *)buffer, maxLen, st->enc);
+            if (n > 0)
+                return n;
+            if (st->enc == LOG_JSON)
+                st->suffixLen = snprintf(st->suffix, sizeof(st->suffix), "\",\"next\":%lu}", (unsigned long)st->cursor);
+            st->stage = 2;
+        }
+        if (st->suffixSent < st->suffixLen)
+            return copyPending(buffer, maxLen, st->suffix, st->suffixLen, st->suffixSent);
+        return 0; });
+}
+
+// Send log lines [cursor, end) as "log" events to one client, or to all when client is null
+static void sendLogEvents(AsyncEventSourceClient *client, uint32_t &cursor, uint32_t end)
+{
+    char chunk[1024];
+    size_t n;
+    while ((n = logFormat(cursor, end, chunk, sizeof(chunk))) > 0)
+    {
+        // One data: line per log line; the browser re-adds the final newline
+        chunk[n - 1] = '\0';
+        if (client)
+            client->send(chunk, "log", cursor);
+        else
+            events.send(chunk, "log", cursor);
+    }
+}
+
+#define METRICS_JSON_MAX 128
+
+void webPushMetrics()
+{
+    if (!webServerStarted.load() || events.count() == 0)
+        return;
+    char json[METRICS_JSON_MAX];
+    formatLatestMetricsJson(json, sizeof(json));
+    events.send(json, "metrics");
+}
+
+bool webTakeConfigApplied()
+{
+    return configApplyPending.exchange(false);
+}
+
+void webServiceEvents()
+{
+    if (!webServerStarted.load() || events.count() == 0)
+        return;
+
+    static uint32_t lastPushMs = 0;
+    const uint32_t nowMs = millis();
+    if ((uint32_t)(nowMs - lastPushMs) < EVENTS_PUSH_INTERVAL_MS)
+        return;
+    lastPushMs = nowMs;
+
+    // An open event stream counts as interactive use (replaces the /ping polling)
+    interactiveLastTouchMs.store(nowMs);
+
+    uint32_t cursor = eventsLogCursor.load();
+    const uint32_t head = logHead();
+    if (cursor != head)
+    {
+        sendLogEvents(nullptr, cursor, head);
+        eventsLogCursor.store(cursor);
+    }
+}
+
+static uint32_t logCursorParam(AsyncWebServerRequest *request)
+{
+    if (!request->hasParam("since"))
+        return 0;
+    return (uint32_t)strtoul(request->getParam("since")->value().c_str(), nullptr, 10);
+}
+
+static void handleDashboard(AsyncWebServerRequest *request)
+{
+    interactiveLastTouchMs.store(millis());
+    char prefix[METRICS_JSON_MAX + 40];
+    size_t n = strlcpy(prefix, "{\"ok\":true,\"metrics\":", sizeof(prefix));
+    n += formatLatestMetricsJson(prefix + n, sizeof(prefix) - n);
+    strlcpy(prefix + n, ",\"logs\":\"", sizeof(prefix) - n);
+    request->send(beginLogStream(request, prefix, logCursorParam(request), LOG_JSON));
+}
+
+// Static files built by tools/build_web_assets.py: <path>, <path>.gz and <path>.etag (content hash).
+// HTML is revalidated on every load (ETag -> 304); css/js are referenced with ?v=<hash> and never change.
+struct StaticAsset
+{
+    const char *path;
+    const char *contentType;
+    bool immutable;
+    char etag[20];
+};
+
+static StaticAsset staticAssets[] = {
+    {"/index.html", "text/html; charset=utf-8", false, ""},
+    {"/style.css", "text/css; charset=utf-8", true, ""},
+    {"/config.html", "text/html; charset=utf-8", false, ""},
+    {"/script_config.js", "application/javascript; charset=utf-8", true, ""},
+};
+
+// Read the ETag sidecars once instead of on every request
+static void loadAssetEtags()
+{
+    char sidecar[40];
+    for (StaticAsset &a : staticAssets)
+    {
+        a.etag[0] = '\0';
+        snprintf(sidecar, sizeof(sidecar), "%s.etag", a.path);
+        File f = LittleFS.open(sidecar, "r");
+        if (!f)
+            continue;
+        size_t n = f.read((uint8_t *)a.etag, sizeof(a.etag) - 1);
+        f.close();
+        while (n > 0 && isspace((unsigned char)a.etag[n - 1]))
+            n--;
+        a.etag[n] = '\0';
+    }
+}
+
+static const StaticAsset *findAsset(const char *path)
+{
+    for (const StaticAsset &a : staticAssets)
+        if (strcmp(a.path, path) == 0)
+            return &a;
+    return nullptr;
+}
+
+static void serveStatic(AsyncWebServerRequest *request, const StaticAsset &asset)
+{
+    char gzPath[40];
+    snprintf(gzPath, sizeof(gzPath), "%s.gz", asset.path);
+    const bool gzip = request->hasHeader("Accept-Encoding") &&
+                      strstr(request->header("Accept-Encoding").c_str(), "gzip") != nullptr &&
+                      LittleFS.exists(gzPath);
+
+    // Strong ETag per representation
+    char etag[28] = "";
+    if (asset.etag[0])
+        snprintf(etag, sizeof(etag), "\"%s%s\"", asset.etag, gzip ? "-gz" : "");
+    // private: some assets sit behind basic auth and must not land in shared caches
+    const char *cacheControl = asset.immutable ? "private, max-age=31536000, immutable" : "no-cache";
+
+    if (etag[0] && request->hasHeader("If-None-Match") &&
+        strstr(request->header("If-None-Match").c_str(), etag) != nullptr)
+    {
+        AsyncWebServerResponse *response = request->beginResponse(304);
+        response->addHeader("ETag", etag);
+        response->addHeader("Cache-Control", cacheControl);
+        response->addHeader("Vary", "Accept-Encoding");
+        request->send(response);
+        return;
+    }
+
+    AsyncWebServerResponse *response = request->beginResponse(LittleFS, gzip ? gzPath : asset.path, asset.contentType);
+    if (gzip)
+        response->addHeader("Content-Encoding", "gzip");
+    if (etag[0])
+    {
+        response->addHeader("ETag", etag);
+        response->addHeader("Cache-Control", cacheControl);
+    }
+    response->addHeader("Vary", "Accept-Encoding");
+    request->send(response);
+}
+
 static void handleGetConfig(AsyncWebServerRequest *request);
 static void handlePostConfig(AsyncWebServerRequest *request, const String &body);
-extern void readTimeAndSensorAndPrepareStrings(float &tempC, float &humidityPct, int &batteryMv);
-extern void epdDraw(bool fullRefresh);
 
 void startWebServer()
 {
@@ -104,6 +324,7 @@ void startWebServer()
         while (true)
             delay(1000);
     }
+    loadAssetEtags();
 
     if (!connectWiFiShort(8000))
     {
@@ -121,9 +342,7 @@ void startWebServer()
               {
         DEBUG_PRINT("[WEB] GET /index.html");
         if (LittleFS.exists("/index.html")) {
-            AsyncWebServerResponse *response = request->beginResponse(LittleFS, "/index.html", "text/html");
-            response->addHeader("Content-Type", "text/html; charset=utf-8");
-            request->send(response);
+            serveStatic(request, *findAsset("/index.html"));
         } else {
             request->send(200, "text/html; charset=utf-8",
                           "<!doctype html><html><body><h2>EPD Clock</h2>"
@@ -133,9 +352,7 @@ void startWebServer()
     server.on("/style.css", HTTP_GET, [](AsyncWebServerRequest *request)
               {
         DEBUG_PRINT("[WEB] GET /style.css");
-        AsyncWebServerResponse *response = request->beginResponse(LittleFS, "/style.css", "text/css");
-        response->addHeader("Content-Type", "text/css; charset=utf-8");
-        request->send(response); });
+        serveStatic(request, *findAsset("/style.css")); });
 
     server.on("/config.html", HTTP_GET, [](AsyncWebServerRequest *request)
               {
@@ -146,9 +363,7 @@ void startWebServer()
             return request->requestAuthentication();
         }
         DEBUG_PRINT("[WEB] GET /config.html (auth OK)");
-        AsyncWebServerResponse *response = request->beginResponse(LittleFS, "/config.html", "text/html");
-        response->addHeader("Content-Type", "text/html; charset=utf-8");
-        request->send(response); });
+        serveStatic(request, *findAsset("/config.html")); });
 
     server.on("/script_config.js", HTTP_GET, [](AsyncWebServerRequest *request)
               {
@@ -159,9 +374,7 @@ void startWebServer()
             return request->requestAuthentication();
         }
         DEBUG_PRINT("[WEB] GET /script_config.js (auth OK)");
-        AsyncWebServerResponse *response = request->beginResponse(LittleFS, "/script_config.js", "application/javascript");
-        response->addHeader("Content-Type", "application/javascript; charset=utf-8");
-        request->send(response); });
+        serveStatic(request, *findAsset("/script_config.js")); });
 
     server.on("/ping", HTTP_POST, [](AsyncWebServerRequest *request)
               {
@@ -185,9 +398,13 @@ void startWebServer()
         }
 
         DEBUG_PRINT("[WEB] POST /api/mqtt/test (attempting test publish)");
+        // The reading on the face: a sensor burst would block the HTTP task for seconds
         float t = 0.0f, h = 0.0f;
         int batt = 0;
-        readTimeAndSensorAndPrepareStrings(t, h, batt);
+        if (!latestReading(t, h, batt)) {
+            request->send(503, "application/json; charset=utf-8", "{\"ok\":false,\"err\":\"no sensor reading\"}");
+            return;
+        }
         bool ok = publishMQTT_reading(t, h, batt);
         if (ok) request->send(200, "application/json; charset=utf-8", "{\"ok\":true}");
         else request->send(500, "application/json; charset=utf-8", "{\"ok\":false}");
@@ -202,65 +419,107 @@ void startWebServer()
             return request->requestAuthentication();
         }
         DEBUG_PRINT("[WEB] GET /api/logs");
-        String logs = getLogs();
-        request->send(200, "text/plain; charset=utf-8", logs);
+        // ?since=<cursor>: only newer lines, as JSON carrying the next cursor
+        if (request->hasParam("since"))
+            request->send(beginLogStream(request, "{\"ok\":true,\"logs\":\"", logCursorParam(request), LOG_JSON));
+        else
+            request->send(beginLogStream(request, "", 0, LOG_TEXT));
     });
 
-    // Combined dashboard endpoint: returns metrics + logs. Also serves as a ping (updates interactive touch)
-    server.on("/api/dashboard", HTTP_POST, [](AsyncWebServerRequest *request)
+    // Wake-cycle phase histograms (min/avg/max/p95 in microseconds, accumulated across deep sleep)
+    server.on("/api/perf", HTTP_GET, [](AsyncWebServerRequest *request)
               {
-        // Update interactive ping (acts like /ping)
-        interactiveLastTouchMs.store(millis());
+        const char *adminUser = ConfigManager::instance().getAdminUser();
+        const char *adminPass = ConfigManager::instance().getAdminPass();
+        if (!request->authenticate(adminUser, adminPass)) {
+            DEBUG_PRINT("[WEB][AUTH] /api/perf auth required");
+            return request->requestAuthentication();
+        }
+        DEBUG_PRINT("[WEB] GET /api/perf");
+        request->send(200, "application/json; charset=utf-8", perfToJson());
+    });
 
-        DEBUG_PRINT("[WEB] POST /api/dashboard");
-        // metrics
-        String metricsJson = getLatestMetricsJson();
-        // logs (escape for JSON)
-        String logs = getLogs();
-        String logsEscaped;
-        logsEscaped.reserve(logs.length() * 2 + 10);
-        for (size_t i = 0; i < logs.length(); i++) {
-            char c = logs.charAt(i);
-            if (c == '"') logsEscaped += "\\\"";
-            else if (c == '\\') logsEscaped += "\\\\";
-            else if (c == '\n') logsEscaped += "\\n";
-            else if (c == '\r') logsEscaped += "\\r";
-            else logsEscaped += c;
+    // Last frame pushed to the panel as binary PBM (P4), for golden-frame diffs on a host
+    server.on("/api/frame.pbm", HTTP_GET, [](AsyncWebServerRequest *request)
+              {
+        const char *adminUser = ConfigManager::instance().getAdminUser();
+        const char *adminPass = ConfigManager::instance().getAdminPass();
+        if (!request->authenticate(adminUser, adminPass)) {
+            DEBUG_PRINT("[WEB][AUTH] /api/frame.pbm auth required");
+            return request->requestAuthentication();
+        }
+        DEBUG_PRINT("[WEB] GET /api/frame.pbm");
+        uint8_t *pixels = (uint8_t *)malloc(EPD_FRAME_BYTES);
+        if (!pixels) {
+            request->send(503, "application/json; charset=utf-8", "{\"ok\":false,\"err\":\"no memory\"}");
+            return;
         }
+        // Copied under the panel lock: streaming the live buffer could mix two frames
+        const EpdCopyResult copied = epdFrameCopyRetained(pixels);
+        if (copied != EPD_COPY_OK) {
+            free(pixels);
+            if (copied == EPD_COPY_BUSY)
+                request->send(503, "application/json; charset=utf-8", "{\"ok\":false,\"err\":\"refresh in progress\"}");
+            else
+                request->send(404, "application/json; charset=utf-8", "{\"ok\":false,\"err\":\"no frame\"}");
+            return;
+        }
+        AsyncResponseStream *response = request->beginResponseStream("image/x-portable-bitmap");
+        response->printf("P4\n%d %d\n", EPD_FRAME_WIDTH, EPD_FRAME_HEIGHT);
+        uint8_t row[EPD_FRAME_STRIDE];
+        for (int y = 0; y < EPD_FRAME_HEIGHT; y++) {
+            // Frame bits are 1 = white, PBM bits are 1 = black
+            for (int i = 0; i < EPD_FRAME_STRIDE; i++)
+                row[i] = (uint8_t)~pixels[y * EPD_FRAME_STRIDE + i];
+            response->write(row, sizeof(row));
+        }
+        free(pixels);
+        request->send(response);
+    });
 
-        String json = "{";
-        json += "\"ok\":true,";
-        json += "\"metrics\":{" + metricsJson + "},";
-        json += "\"logs\":\"" + logsEscaped + "\"";
-        json += "}";
+    // Stored readings in [from, to] (epoch seconds), streamed in chunks.
+    // step > 0 downsamples to min/avg/max per bucket; format=csv for CSV output (no auth, like /api/dashboard)
+    server.on("/api/history", HTTP_GET, [](AsyncWebServerRequest *request)
+              {
+        interactiveLastTouchMs.store(millis());
+        const uint32_t now = (uint32_t)time(nullptr);
+        uint32_t to = request->hasParam("to") ? (uint32_t)strtoul(request->getParam("to")->value().c_str(), nullptr, 10) : now;
+        uint32_t from = request->hasParam("from") ? (uint32_t)strtoul(request->getParam("from")->value().c_str(), nullptr, 10)
+                                                  : (to > 86400UL ? to - 86400UL : 0);
+        uint32_t step = request->hasParam("step") ? (uint32_t)strtoul(request->getParam("step")->value().c_str(), nullptr, 10) : 0;
+        const bool csv = request->hasParam("format") && request->getParam("format")->value() == "csv";
+        DEBUG_PRINTF("[WEB] GET /api/history from=%lu to=%lu step=%lu\n",
+                     (unsigned long)from, (unsigned long)to, (unsigned long)step);
+        if (from > to) {
+            request->send(400, "application/json; charset=utf-8", "{\"ok\":false,\"err\":\"from > to\"}");
+            return;
+        }
 
-        request->send(200, "application/json; charset=utf-8", json);
+        std::shared_ptr<HistoryExport> exp(historyExportBegin(from, to, step, csv ? HISTORY_CSV : HISTORY_JSON),
+                                           historyExportEnd);
+        if (!exp) {
+            request->send(503, "application/json; charset=utf-8", "{\"ok\":false,\"err\":\"no memory\"}");
+            return;
+        }
+        AsyncWebServerResponse *response = request->beginChunkedResponse(
+            csv ? "text/csv; charset=utf-8" : "application/json; charset=utf-8",
+            [exp](uint8_t *buffer, size_t maxLen, size_t index) -> size_t
+            { return historyExportRead(exp.get(), buffer, maxLen); });
+        request->send(response);
     });
 
+    // Combined dashboard endpoint: returns metrics + logs since ?since=<cursor> (all buffered lines without it).
+    // Also serves as a ping (updates interactive touch)
+    server.on("/api/dashboard", HTTP_POST, [](AsyncWebServerRequest *request)
+              {
+        DEBUG_PRINT("[WEB] POST /api/dashboard");
+        handleDashboard(request); });
+
     // Allow GET as well for simple polling (no auth)
     server.on("/api/dashboard", HTTP_GET, [](AsyncWebServerRequest *request)
               {
-        interactiveLastTouchMs.store(millis());
         DEBUG_PRINT("[WEB] GET /api/dashboard");
-        String metricsJson = getLatestMetricsJson();
-        String logs = getLogs();
-        String logsEscaped;
-        logsEscaped.reserve(logs.length() * 2 + 10);
-        for (size_t i = 0; i < logs.length(); i++) {
-            char c = logs.charAt(i);
-            if (c == '"') logsEscaped += "\\\"";
-            else if (c == '\\') logsEscaped += "\\\\";
-            else if (c == '\n') logsEscaped += "\\n";
-            else if (c == '\r') logsEscaped += "\\r";
-            else logsEscaped += c;
-        }
-        String json = "{";
-        json += "\"ok\":true,";
-        json += "\"metrics\":{" + metricsJson + "},";
-        json += "\"logs\":\"" + logsEscaped + "\"";
-        json += "}";
-        request->send(200, "application/json; charset=utf-8", json);
-    });
+        handleDashboard(request); });
 
     // Scan Wi-Fi networks (STA/APSTA/AP). Returns a small JSON with SSID + RSSI
     server.on("/api/wifi/scan", HTTP_GET, [](AsyncWebServerRequest *request)
@@ -353,7 +612,21 @@ void startWebServer()
         ESP.restart();
     });
 
+    eventsLogCursor.store(logHead());
+    events.onConnect([](AsyncEventSourceClient *client)
+                     {
+        interactiveLastTouchMs.store(millis());
+        DEBUG_PRINTF("[WEB] SSE client connected (%u open)\n", (unsigned)events.count());
+        // Backlog up to the broadcast position; newer lines follow with the next push
+        uint32_t cursor = client->lastId();
+        sendLogEvents(client, cursor, eventsLogCursor.load());
+        char json[METRICS_JSON_MAX];
+        formatLatestMetricsJson(json, sizeof(json));
+        client->send(json, "metrics"); });
+    server.addHandler(&events);
+
     server.begin();
+    webServerStarted.store(true);
     DEBUG_PRINT("[WEB] Web server started.");
 }
 
@@ -395,18 +668,8 @@ static void handlePostConfig(AsyncWebServerRequest *request, const String &body)
     if (okUpdate)
     {
         DEBUG_PRINT("[WEB] Configuration updated (deferred save).");
-        // Apply changes immediately: re-read sensors and refresh display so offsets take effect
-        {
-            float tmpT = 0.0f, tmpH = 0.0f;
-            int batt = 0;
-            // readTimeAndSensorAndPrepareStrings updates latest_* snapshot
-            readTimeAndSensorAndPrepareStrings(tmpT, tmpH, batt);
-            // If the device is in interactive mode, refresh the EPD now
-            extern bool interactiveMode;
-            if (interactiveMode) {
-                epdDraw(false);
-            }
-        }
+        // Re-read and redraw on the loop so offsets take effect at once
+        configApplyPending.store(true);
         request->send(200, "application/json; charset=utf-8", "{\"ok\":true}");
     }
     else
@@ -2,3 +2,11 @@
 #include <Arduino.h>
 
 void startWebServer();
+
+// Server-Sent Events (/api/events): push the latest reading to open dashboards
+void webPushMetrics();
+// Call from the interactive loop: forwards new log lines and keeps the device awake while a dashboard is open
+void webServiceEvents();
+// True once after a configuration POST: the loop re-reads the sensors and redraws, so new
+// offsets show at once (the HTTP task never touches the sensor or the frame)
+bool webTakeConfigApplied();
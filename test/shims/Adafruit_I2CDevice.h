@@ -0,0 +1,2 @@
+#pragma once
+// Adafruit_GFX.h includes the BusIO headers; no bus device is used on the host
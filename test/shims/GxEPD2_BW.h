@@ -0,0 +1,9 @@
+#pragma once
+// Host stand-in for GxEPD2: colour values and the panel driver type named in epd_frame.h.
+// Nothing talks to a panel on the host; frames are rendered into a FrameCanvas.
+#include <Adafruit_GFX.h>
+
+#define GxEPD_BLACK 0x0000
+#define GxEPD_WHITE 0xFFFF
+
+class GxEPD2_154_D67;
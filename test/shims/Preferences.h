@@ -0,0 +1,83 @@
+#pragma once
+// Host stand-in for the ESP32 Preferences (NVS) API: namespaces of typed values kept in
+// process memory. shimPreferencesClear() wipes them between tests.
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include <string>
+
+inline std::map<std::string, std::map<std::string, std::string>> &shimPreferencesStore()
+{
+    static std::map<std::string, std::map<std::string, std::string>> store;
+    return store;
+}
+
+inline void shimPreferencesClear() { shimPreferencesStore().clear(); }
+
+class Preferences
+{
+public:
+    bool begin(const char *name, bool readOnly = false)
+    {
+        ns_ = &shimPreferencesStore()[name];
+        readOnly_ = readOnly;
+        return true;
+    }
+    void end() { ns_ = nullptr; }
+
+    bool isKey(const char *key) const { return ns_ && ns_->count(key); }
+
+    size_t putString(const char *key, const char *value) { return put(key, std::string(value ? value : "")); }
+    size_t getString(const char *key, char *value, size_t maxLen) const
+    {
+        const std::string *v = find(key);
+        if (!v || !value || maxLen == 0 || v->size() + 1 > maxLen)
+            return 0;
+        memcpy(value, v->c_str(), v->size() + 1);
+        return v->size() + 1;
+    }
+
+    size_t putBool(const char *key, bool value) { return putValue(key, (uint8_t)value); }
+    bool getBool(const char *key, bool defaultValue = false) const { return getValue<uint8_t>(key, defaultValue) != 0; }
+    size_t putUShort(const char *key, uint16_t value) { return putValue(key, value); }
+    uint16_t getUShort(const char *key, uint16_t defaultValue = 0) const { return getValue(key, defaultValue); }
+    size_t putUInt(const char *key, uint32_t value) { return putValue(key, value); }
+    uint32_t getUInt(const char *key, uint32_t defaultValue = 0) const { return getValue(key, defaultValue); }
+    size_t putFloat(const char *key, float value) { return putValue(key, value); }
+    float getFloat(const char *key, float defaultValue = NAN) const { return getValue(key, defaultValue); }
+
+private:
+    const std::string *find(const char *key) const
+    {
+        if (!ns_)
+            return nullptr;
+        auto it = ns_->find(key);
+        return (it == ns_->end()) ? nullptr : &it->second;
+    }
+
+    size_t put(const char *key, const std::string &bytes)
+    {
+        if (!ns_ || readOnly_)
+            return 0;
+        (*ns_)[key] = bytes;
+        return bytes.size();
+    }
+
+    template <typename T>
+    size_t putValue(const char *key, T value) { return put(key, std::string((const char *)&value, sizeof(T))); }
+
+    template <typename T>
+    T getValue(const char *key, T defaultValue) const
+    {
+        const std::string *v = find(key);
+        if (!v || v->size() != sizeof(T))
+            return defaultValue;
+        T value;
+        memcpy(&value, v->data(), sizeof(T));
+        return value;
+    }
+
+    std::map<std::string, std::string> *ns_ = nullptr;
+    bool readOnly_ = false;
+};
@@ -0,0 +1,104 @@
+#pragma once
+// Host stand-in for the Arduino String class (subset used by the sources)
+#include <stddef.h>
+#include <stdio.h>
+#include <string>
+
+class __FlashStringHelper;
+
+class String
+{
+public:
+    String() {}
+    String(const char *s) : s_(s ? s : "") {}
+    String(const __FlashStringHelper *s) : s_(reinterpret_cast<const char *>(s)) {}
+    explicit String(char c) : s_(1, c) {}
+    explicit String(int v) : s_(std::to_string(v)) {}
+    explicit String(unsigned int v) : s_(std::to_string(v)) {}
+    explicit String(long v) : s_(std::to_string(v)) {}
+    explicit String(unsigned long v) : s_(std::to_string(v)) {}
+    explicit String(float v, unsigned char decimals = 2) : String((double)v, decimals) {}
+    explicit String(double v, unsigned char decimals = 2)
+    {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+        s_ = buf;
+    }
+
+    const char *c_str() const { return s_.c_str(); }
+    unsigned int length() const { return (unsigned int)s_.size(); }
+    bool isEmpty() const { return s_.empty(); }
+    bool reserve(unsigned int size)
+    {
+        s_.reserve(size);
+        return true;
+    }
+
+    bool concat(const char *s)
+    {
+        s_ += s;
+        return true;
+    }
+    bool concat(const char *s, unsigned int n)
+    {
+        s_.append(s, n);
+        return true;
+    }
+    bool concat(char c)
+    {
+        s_ += c;
+        return true;
+    }
+    bool concat(const String &s)
+    {
+        s_ += s.s_;
+        return true;
+    }
+
+    String &operator+=(const char *s)
+    {
+        concat(s);
+        return *this;
+    }
+    String &operator+=(char c)
+    {
+        concat(c);
+        return *this;
+    }
+    String &operator+=(const String &s)
+    {
+        concat(s);
+        return *this;
+    }
+
+    char operator[](unsigned int i) const { return (i < s_.size()) ? s_[i] : '\0'; }
+    bool operator==(const String &o) const { return s_ == o.s_; }
+    bool operator==(const char *o) const { return s_ == (o ? o : ""); }
+    bool operator!=(const String &o) const { return !(*this == o); }
+    bool operator!=(const char *o) const { return !(*this == o); }
+
+private:
+    std::string s_;
+};
+
+// Type of "a" + String concatenations in the core; ArduinoJson names it in its string adapters
+class StringSumHelper : public String
+{
+public:
+    StringSumHelper(const String &s) : String(s) {}
+    StringSumHelper(const char *s) : String(s) {}
+};
+
+inline StringSumHelper operator+(const StringSumHelper &lhs, const String &rhs)
+{
+    StringSumHelper sum(lhs);
+    sum += rhs;
+    return sum;
+}
+
+inline StringSumHelper operator+(const StringSumHelper &lhs, const char *rhs)
+{
+    StringSumHelper sum(lhs);
+    sum += rhs;
+    return sum;
+}
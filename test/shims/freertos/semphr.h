@@ -0,0 +1,61 @@
+#pragma once
+#include "FreeRTOS.h"
+
+struct ShimSemaphore
+{
+    std::mutex m;
+    std::condition_variable cv;
+    UBaseType_t count;
+    UBaseType_t max;
+};
+
+typedef ShimSemaphore *SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateBinary()
+{
+    SemaphoreHandle_t s = new ShimSemaphore;
+    s->count = 0;
+    s->max = 1;
+    return s;
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+    SemaphoreHandle_t s = xSemaphoreCreateBinary();
+    s->count = 1;
+    return s;
+}
+
+inline void vSemaphoreDelete(SemaphoreHandle_t s) { delete s; }
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks)
+{
+    std::unique_lock<std::mutex> lock(s->m);
+    auto ready = [s] { return s->count > 0; };
+    if (ticks == portMAX_DELAY)
+        s->cv.wait(lock, ready);
+    else if (!s->cv.wait_for(lock, std::chrono::milliseconds(ticks), ready))
+        return pdFALSE;
+    s->count--;
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t s)
+{
+    {
+        std::lock_guard<std::mutex> lock(s->m);
+        if (s->count >= s->max)
+            return pdFALSE;
+        s->count++;
+    }
+    s->cv.notify_one();
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t s, BaseType_t *woken)
+{
+    const BaseType_t given = xSemaphoreGive(s);
+    if (woken)
+        *woken = given;
+    return given;
+}
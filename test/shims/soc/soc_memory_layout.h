@@ -0,0 +1,3 @@
+#pragma once
+// Host build: nothing lives in a flash-mapped data segment, every string is copied
+inline bool esp_ptr_in_drom(const void *) { return false; }
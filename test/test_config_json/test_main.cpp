@@ -0,0 +1,151 @@
+// Host checks of ConfigManager (defaults, NVS round trip, masked JSON export) and of the
+// allocation-free metrics JSON written for the web UI and MQTT
+#include <unity.h>
+#include <Preferences.h>
+#include "config_manager.h"
+#include "metrics_json.h"
+#include <atomic>
+#include <thread>
+
+void setUp() {}
+void tearDown() {}
+
+static void test_defaults_on_empty_store()
+{
+    shimPreferencesClear();
+    ConfigManager &cm = ConfigManager::instance();
+    TEST_ASSERT_TRUE(cm.begin());
+    const AppConfig &cfg = cm.snapshot();
+    TEST_ASSERT_EQUAL_STRING("EPD-Clock", cfg.device_name);
+    TEST_ASSERT_EQUAL_UINT16(1883, cfg.mqtt_port);
+    TEST_ASSERT_EQUAL_UINT32(5, cfg.interactive_timeout_min);
+    TEST_ASSERT_EQUAL_UINT32(60, cfg.mqtt_max_silence_min);
+    TEST_ASSERT_EQUAL_FLOAT(0.2f, cfg.mqtt_deadband_temp_c);
+    TEST_ASSERT_EQUAL_UINT16(5, cfg.median_n);
+}
+
+static void test_saved_config_loads_back()
+{
+    ConfigManager &cm = ConfigManager::instance();
+    Preferences prefs;
+    prefs.begin("config", false);
+    prefs.putString("dev_name", "Kitchen");
+    prefs.putUInt("deep_int_min", 15);
+    prefs.end();
+
+    TEST_ASSERT_TRUE(cm.begin());
+    const uint32_t gen = cm.generation();
+    TEST_ASSERT_EQUAL_STRING("Kitchen", cm.snapshot().device_name);
+    TEST_ASSERT_EQUAL_UINT32(15, cm.snapshot().deepsleep_interval_min);
+    TEST_ASSERT_TRUE(cm.save());
+    TEST_ASSERT_TRUE(cm.begin());
+    TEST_ASSERT_TRUE(cm.generation() != gen);
+    TEST_ASSERT_EQUAL_STRING("Kitchen", cm.snapshot().device_name);
+}
+
+static void test_json_export_masks_secrets()
+{
+    const String json = ConfigManager::instance().toJsonString();
+    TEST_ASSERT_NOT_NULL(strstr(json.c_str(), "\"device_name\":\"Kitchen\""));
+    TEST_ASSERT_NOT_NULL(strstr(json.c_str(), "\"admin_pass\":\"*****\""));
+    TEST_ASSERT_NULL(strstr(json.c_str(), "\"admin_pass\":\"admin\""));
+}
+
+// An MQTT config command is applied right away but written to flash by the main loop
+static void test_update_without_async_save()
+{
+    ConfigManager &cm = ConfigManager::instance();
+    TEST_ASSERT_TRUE(cm.updateFromJson("{\"device_name\":\"Garage\"}", /*saveAsync=*/false));
+    TEST_ASSERT_EQUAL_STRING("Garage", cm.snapshot().device_name);
+
+    char stored[32] = "";
+    Preferences prefs;
+    prefs.begin("config", true);
+    prefs.getString("dev_name", stored, sizeof(stored));
+    TEST_ASSERT_EQUAL_STRING("Kitchen", stored);
+
+    TEST_ASSERT_TRUE(cm.save());
+    prefs.getString("dev_name", stored, sizeof(stored));
+    prefs.end();
+    TEST_ASSERT_EQUAL_STRING("Garage", stored);
+}
+
+// Two settings written together must be copied together while another task publishes
+static void test_copy_snapshot_is_consistent()
+{
+    ConfigManager &cm = ConfigManager::instance();
+    std::atomic<bool> done{false};
+    std::thread publisher([&]
+                          {
+        for (int i = 0; i < 500; i++)
+        {
+            Preferences prefs;
+            prefs.begin("config", false);
+            prefs.putString("dev_name", (i & 1) ? "Odd" : "Even");
+            prefs.putUInt("deep_int_min", (i & 1) ? 11 : 22);
+            prefs.end();
+            cm.begin();
+            delayMicroseconds(100);
+        }
+        done.store(true); });
+
+    uint32_t copies = 0;
+    AppConfig cfg;
+    while (!done.load())
+    {
+        cm.copySnapshot(cfg);
+        const bool odd = strcmp(cfg.device_name, "Odd") == 0;
+        if (odd || strcmp(cfg.device_name, "Even") == 0)
+        {
+            TEST_ASSERT_EQUAL_UINT32(odd ? 11 : 22, cfg.deepsleep_interval_min);
+            copies++;
+        }
+    }
+    publisher.join();
+    TEST_ASSERT_GREATER_THAN(0, copies);
+}
+
+static void test_metrics_web_and_mqtt()
+{
+    const MetricsRecord r = {metricsCenti(21.456f), metricsCenti(-0.5f), 3650, 1760000000, "12:34", "16/10/26", -67};
+    char out[160];
+    TEST_ASSERT_TRUE(formatMetricsJson(out, sizeof(out), r, METRICS_WEB) > 0);
+    TEST_ASSERT_EQUAL_STRING("{\"temp\":21.46,\"humidity\":-0.50,\"battery_mv\":3650,\"time\":\"12:34\",\"date\":\"16/10/26\"}",
+                             out);
+    TEST_ASSERT_TRUE(formatMetricsJson(out, sizeof(out), r, METRICS_MQTT) > 0);
+    TEST_ASSERT_EQUAL_STRING("{\"temperature_c\":21.46,\"humidity_pct\":-0.50,\"battery_mv\":3650,\"battery_pct\":50,"
+                             "\"rssi\":-67,\"ts\":1760000000}",
+                             out);
+}
+
+static void test_metrics_without_a_reading()
+{
+    TEST_ASSERT_EQUAL_INT32(METRICS_NO_VALUE, metricsCenti(NAN));
+    TEST_ASSERT_EQUAL_INT32(METRICS_NO_VALUE, metricsCenti(INFINITY));
+    TEST_ASSERT_EQUAL_INT32(METRICS_NO_VALUE, metricsCenti(-3.0e7f));
+    const MetricsRecord r = {metricsCenti(NAN), metricsCenti(55.0f), 3650, 0, nullptr, nullptr, 0};
+    char out[160];
+    TEST_ASSERT_TRUE(formatMetricsJson(out, sizeof(out), r, METRICS_MQTT) > 0);
+    TEST_ASSERT_EQUAL_STRING("{\"temperature_c\":null,\"humidity_pct\":55.00,\"battery_mv\":3650,\"battery_pct\":50}", out);
+}
+
+static void test_metrics_overflow_returns_zero()
+{
+    const MetricsRecord r = {2100, 4800, 4200, 0, nullptr, nullptr, 0};
+    char out[16];
+    TEST_ASSERT_EQUAL_size_t(0, formatMetricsJson(out, sizeof(out), r, METRICS_MQTT));
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_defaults_on_empty_store);
+    RUN_TEST(test_saved_config_loads_back);
+    RUN_TEST(test_json_export_masks_secrets);
+    RUN_TEST(test_update_without_async_save);
+    RUN_TEST(test_copy_snapshot_is_consistent);
+    RUN_TEST(test_metrics_web_and_mqtt);
+    RUN_TEST(test_metrics_without_a_reading);
+    RUN_TEST(test_metrics_overflow_returns_zero);
+    return UNITY_END();
+}
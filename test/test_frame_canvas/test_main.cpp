@@ -0,0 +1,212 @@
+// Host checks of FrameCanvas against plain Adafruit_GFX (GFXcanvas1): the row-based text and
+// span fills must set exactly the same pixels, and the text cost per frame of both is printed
+#include <unity.h>
+#include <GxEPD2_BW.h>
+#include "fonts.h"
+#include "frame_canvas.h"
+
+#define CANVAS_W 200
+#define CANVAS_H 200
+#define CANVAS_BYTES (((CANVAS_W + 7) / 8) * CANVAS_H)
+
+static FrameCanvas fast(CANVAS_W, CANVAS_H);
+static GFXcanvas1 reference(CANVAS_W, CANVAS_H);
+
+static const GFXfont *const fonts[] = {
+    &DSEG7_Classic_Bold_36,
+    &DejaVu_Sans_Condensed_Bold_15,
+    &DejaVu_Sans_Condensed_Bold_18,
+    &DejaVu_Sans_Condensed_Bold_23,
+};
+
+// Same noise on both canvases, so a wrong edge mask shows up as a changed neighbour pixel
+static void fillNoise(uint32_t seed)
+{
+    uint8_t *a = fast.getBuffer();
+    uint8_t *b = reference.getBuffer();
+    for (size_t i = 0; i < CANVAS_BYTES; i++)
+    {
+        seed = seed * 1664525UL + 1013904223UL;
+        a[i] = b[i] = (uint8_t)(seed >> 24);
+    }
+}
+
+static void assertSamePixels(const char *what)
+{
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(reference.getBuffer(), fast.getBuffer(), CANVAS_BYTES, what);
+}
+
+static void printBoth(const GFXfont *font, uint8_t size, uint16_t color, int16_t x, int16_t y, const char *text)
+{
+    Adafruit_GFX *targets[] = {&fast, &reference};
+    for (Adafruit_GFX *gfx : targets)
+    {
+        gfx->setFont(font);
+        gfx->setTextSize(size);
+        gfx->setTextColor(color);
+        gfx->setTextWrap(false);
+        gfx->setCursor(x, y);
+        gfx->print(text);
+    }
+}
+
+static void test_text_matches_adafruit_gfx()
+{
+    // Every printable glyph, at each bit offset within a byte and across all four edges
+    static const char glyphs[] =
+        " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
+    static const int16_t origins[][2] = {{0, 40}, {-9, 30}, {150, 60}, {20, 8}, {20, 196}};
+    char label[48];
+    fast.setGlyphAtlas(nullptr, 0, 0);
+    for (const GFXfont *font : fonts)
+    {
+        for (const auto &o : origins)
+        {
+            for (int16_t dx = 0; dx < 8; dx++)
+            {
+                const uint16_t color = dx & 1;
+                fillNoise(o[0] * 31 + dx);
+                printBoth(font, 1, color, o[0] + dx, o[1], glyphs);
+                printBoth(font, 1, color, o[0] + dx, o[1] + 60, glyphs + 47);
+                snprintf(label, sizeof(label), "font %u at %d,%d", (unsigned)font->yAdvance, o[0] + dx, o[1]);
+                assertSamePixels(label);
+            }
+        }
+    }
+}
+
+static void test_atlas_and_fallbacks_match_adafruit_gfx()
+{
+    TEST_ASSERT_TRUE(fast.setGlyphAtlas(&DSEG7_Classic_Bold_36, '0', ':'));
+    for (int16_t dx = 0; dx < 8; dx++)
+    {
+        fillNoise(100 + dx);
+        printBoth(&DSEG7_Classic_Bold_36, 1, GxEPD_BLACK, 18 + dx, 130, "12:34 -- 56:78 90");
+        printBoth(&DSEG7_Classic_Bold_36, 1, GxEPD_WHITE, -20 + dx, 40, "09:87");
+        assertSamePixels("glyph atlas");
+    }
+
+    // Scaled text goes through Adafruit_GFX unchanged
+    fillNoise(7);
+    printBoth(&DejaVu_Sans_Condensed_Bold_15, 2, GxEPD_BLACK, 3, 60, "21.5 C");
+    assertSamePixels("text size 2");
+    TEST_ASSERT_FALSE(fast.setGlyphAtlas(&DSEG7_Classic_Bold_36, 0x10, ':'));
+}
+
+static void test_shapes_match_adafruit_gfx()
+{
+    char label[48];
+    static const int16_t rects[][4] = {
+        {0, 0, 200, 200}, {3, 5, 1, 1}, {7, 9, 2, 30}, {8, 1, 8, 4}, {13, 20, 60, 3}, {-5, -5, 12, 12},
+        {190, 190, 20, 20}, {50, 60, 9, -7}, {50, 60, 0, 5}, {154, 12, 4, 8},
+    };
+    for (const auto &r : rects)
+    {
+        for (uint16_t color = 0; color < 2; color++)
+        {
+            fillNoise(r[0] + r[2]);
+            fast.fillRect(r[0], r[1], r[2], r[3], color);
+            reference.fillRect(r[0], r[1], r[2], r[3], color);
+            snprintf(label, sizeof(label), "fillRect %d,%d %dx%d", r[0], r[1], r[2], r[3]);
+            assertSamePixels(label);
+        }
+    }
+
+    // Radii past FRAME_SPAN_MAX_R take the Adafruit_GFX path
+    for (int16_t r = 0; r <= FRAME_SPAN_MAX_R + 4; r++)
+    {
+        fillNoise(r);
+        const int16_t cx = (r * 7) % 200;
+        fast.fillCircle(cx, 100, r, r & 1);
+        reference.fillCircle(cx, 100, r, r & 1);
+        fast.fillCircle(3, 197, r / 2, GxEPD_BLACK);
+        reference.fillCircle(3, 197, r / 2, GxEPD_BLACK);
+        snprintf(label, sizeof(label), "fillCircle r=%d", r);
+        assertSamePixels(label);
+    }
+
+    static const int16_t rounds[][5] = {
+        {10, 10, 60, 30, 6}, {11, 50, 7, 7, 3}, {40, 40, 100, 20, 30}, {-6, 150, 40, 60, 12},
+        {120, 120, 90, 90, 0}, {5, 5, 190, 190, 70}, {33, 77, 1, 9, 2},
+    };
+    for (const auto &r : rounds)
+    {
+        for (uint16_t color = 0; color < 2; color++)
+        {
+            fillNoise(r[2] * r[3]);
+            fast.fillRoundRect(r[0], r[1], r[2], r[3], r[4], color);
+            reference.fillRoundRect(r[0], r[1], r[2], r[3], r[4], color);
+            snprintf(label, sizeof(label), "fillRoundRect %dx%d r=%d", r[2], r[3], r[4]);
+            assertSamePixels(label);
+        }
+    }
+}
+
+// The text of one clock face frame (clock_face.cpp positions and fonts)
+static void drawFaceText(Adafruit_GFX &gfx)
+{
+    struct Line
+    {
+        const GFXfont *font;
+        uint16_t color;
+        int16_t x, y;
+        const char *text;
+    };
+    static const Line lines[] = {
+        {&DSEG7_Classic_Bold_36, GxEPD_BLACK, 18, 130, "12:34"},
+        {&DejaVu_Sans_Condensed_Bold_15, GxEPD_BLACK, 60, 177, "21.5"},
+        {&DejaVu_Sans_Condensed_Bold_15, GxEPD_BLACK, 135, 177, "48.0"},
+        {&DejaVu_Sans_Condensed_Bold_15, GxEPD_BLACK, 120, 78, "MQTT"},
+        {&DejaVu_Sans_Condensed_Bold_15, GxEPD_WHITE, 156, 110, "FR"},
+        {&DejaVu_Sans_Condensed_Bold_18, GxEPD_WHITE, 27, 76, "16/10/26"},
+        {&DejaVu_Sans_Condensed_Bold_23, GxEPD_BLACK, 120, 62, "1.0.0"},
+        {&DejaVu_Sans_Condensed_Bold_15, GxEPD_BLACK, 40, 200, "STA 192.168.1.20"},
+        {&DejaVu_Sans_Condensed_Bold_18, GxEPD_BLACK, 30, 25, "EPD-Clock"},
+    };
+    gfx.setTextSize(1);
+    for (const Line &l : lines)
+    {
+        gfx.setFont(l.font);
+        gfx.setTextColor(l.color);
+        gfx.setCursor(l.x, l.y);
+        gfx.print(l.text);
+    }
+}
+
+static uint32_t textNsPerFrame(Adafruit_GFX &gfx)
+{
+    const uint32_t runs = 2000;
+    const uint32_t start = micros();
+    for (uint32_t i = 0; i < runs; i++)
+        drawFaceText(gfx);
+    return (uint32_t)((uint64_t)(micros() - start) * 1000 / runs);
+}
+
+static void test_text_cost_per_frame()
+{
+    fast.setGlyphAtlas(&DSEG7_Classic_Bold_36, '0', ':');
+    fillNoise(1);
+    drawFaceText(fast);
+    drawFaceText(reference);
+    assertSamePixels("clock face text");
+
+    const uint32_t before = textNsPerFrame(reference);
+    const uint32_t after = textNsPerFrame(fast);
+    char msg[96];
+    snprintf(msg, sizeof(msg), "face text: Adafruit_GFX %lu ns/frame, FrameCanvas %lu ns/frame",
+             (unsigned long)before, (unsigned long)after);
+    TEST_MESSAGE(msg);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_text_matches_adafruit_gfx);
+    RUN_TEST(test_atlas_and_fallbacks_match_adafruit_gfx);
+    RUN_TEST(test_shapes_match_adafruit_gfx);
+    RUN_TEST(test_text_cost_per_frame);
+    return UNITY_END();
+}
@@ -0,0 +1,99 @@
+// Host benchmark of the shared metrics schema (metrics_json.h) against the builders it
+// replaced: String concatenation for the dashboard, snprintf("%.2f") for MQTT.
+// The dashboard output has to stay byte-identical.
+#include <unity.h>
+#include "metrics_json.h"
+
+#define BENCH_VALUES 6001 // -20.00 .. 40.00 degC in 0.01 steps
+
+static volatile size_t sink;
+
+void setUp() {}
+void tearDown() {}
+
+// Former getLatestMetricsJson(), wrapped in braces like the SSE metrics event
+static String legacyWebJson(float tempC, float humidity, int batteryMv, const char *timeStr, const char *dateStr)
+{
+    String s = "";
+    s += "\"temp\":" + String(tempC, 2) + ",";
+    s += "\"humidity\":" + String(humidity, 2) + ",";
+    s += "\"battery_mv\":" + String(batteryMv) + ",";
+    s += "\"time\":\"" + String(timeStr) + "\",";
+    s += "\"date\":\"" + String(dateStr) + "\"";
+    return "{" + s + "}";
+}
+
+// Former backlog replay payload
+static int legacyMqttJson(char *out, size_t cap, int16_t tempCenti, uint16_t humCenti, uint16_t batteryMv,
+                          uint32_t epoch)
+{
+    int n = snprintf(out, cap, "{\"temperature_c\":%.2f,\"humidity_pct\":%.2f,\"battery_mv\":%u",
+                     tempCenti / 100.0f, humCenti / 100.0f, batteryMv);
+    n += snprintf(out + n, cap - n, ",\"ts\":%lu}", (unsigned long)epoch);
+    return n;
+}
+
+static float benchTemp(int i) { return -20.0f + i * 0.01f; }
+
+static void report(const char *name, uint32_t us)
+{
+    char msg[80];
+    snprintf(msg, sizeof(msg), "%s: %lu ns/object", name, (unsigned long)(us * 1000ULL / BENCH_VALUES));
+    TEST_MESSAGE(msg);
+}
+
+static void test_web_output_unchanged()
+{
+    char out[160];
+    for (int i = 0; i < BENCH_VALUES; i++)
+    {
+        const float t = benchTemp(i);
+        const MetricsRecord r = {metricsCenti(t), metricsCenti(t + 60.0f), 3650, 0, "12:34", "16/10/26", 0};
+        TEST_ASSERT_TRUE(formatMetricsJson(out, sizeof(out), r, METRICS_WEB) > 0);
+        const String legacy = legacyWebJson(t, t + 60.0f, 3650, "12:34", "16/10/26");
+        TEST_ASSERT_EQUAL_STRING(legacy.c_str(), out);
+    }
+}
+
+static void test_web_benchmark()
+{
+    char out[160];
+    uint32_t start = micros();
+    for (int i = 0; i < BENCH_VALUES; i++)
+        sink = legacyWebJson(benchTemp(i), 48.5f, 3650, "12:34", "16/10/26").length();
+    report("web, String concatenation", micros() - start);
+
+    start = micros();
+    for (int i = 0; i < BENCH_VALUES; i++)
+    {
+        const MetricsRecord r = {metricsCenti(benchTemp(i)), 4850, 3650, 0, "12:34", "16/10/26", 0};
+        sink = formatMetricsJson(out, sizeof(out), r, METRICS_WEB);
+    }
+    report("web, formatMetricsJson", micros() - start);
+}
+
+static void test_mqtt_benchmark()
+{
+    char out[160];
+    uint32_t start = micros();
+    for (int i = 0; i < BENCH_VALUES; i++)
+        sink = legacyMqttJson(out, sizeof(out), (int16_t)(i - 2000), 4850, 3650, 1760000000UL + i);
+    report("mqtt, snprintf", micros() - start);
+
+    start = micros();
+    for (int i = 0; i < BENCH_VALUES; i++)
+    {
+        const MetricsRecord r = {i - 2000, 4850, 3650, (uint32_t)(1760000000UL + i), nullptr, nullptr, -67};
+        sink = formatMetricsJson(out, sizeof(out), r, METRICS_MQTT);
+    }
+    report("mqtt, formatMetricsJson", micros() - start);
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_web_output_unchanged);
+    RUN_TEST(test_web_benchmark);
+    RUN_TEST(test_mqtt_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,103 @@
+// Host checks of the clock face renderer: determinism, dirty area of a minute tick,
+// render time, and a PBM dump of the frame (FRAME_PBM=<path>, default .pio/native_frame.pbm)
+#include <unity.h>
+#include "clock_face.h"
+#include "config_manager.h"
+#include "epd_frame.h"
+#include "face_layer.h"
+
+static FrameCanvas frame(EPD_FRAME_WIDTH, EPD_FRAME_HEIGHT);
+static AppConfig cfg;
+static uint8_t previous[EPD_FRAME_BYTES];
+
+static ClockFaceText sampleText()
+{
+    return {"12:34", "16/10/26", "21.5", "48.0", "STA 192.168.1.20", 5, 3, false};
+}
+
+// Binary PBM (P4): 1 = black, the inverse of the frame buffer
+static bool writePbm(const char *path, const uint8_t *pixels)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return false;
+    fprintf(f, "P4\n%d %d\n", EPD_FRAME_WIDTH, EPD_FRAME_HEIGHT);
+    for (size_t i = 0; i < EPD_FRAME_BYTES; i++)
+        fputc((uint8_t)~pixels[i], f);
+    return fclose(f) == 0;
+}
+
+void setUp()
+{
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.mqtt_enabled = true;
+    strlcpy(cfg.device_name, "EPD-Clock", sizeof(cfg.device_name));
+    strlcpy(cfg.app_version, "1.0.0", sizeof(cfg.app_version));
+    clockFaceBegin(frame);
+}
+
+void tearDown() {}
+
+static void test_render_is_deterministic()
+{
+    const ClockFaceText text = sampleText();
+    clockFaceRender(frame, text, cfg);
+    memcpy(previous, frame.getBuffer(), EPD_FRAME_BYTES);
+    clockFaceRender(frame, text, cfg);
+    TEST_ASSERT_EQUAL_MEMORY(previous, frame.getBuffer(), EPD_FRAME_BYTES);
+    TEST_ASSERT_TRUE(memcmp(faceLayer, frame.getBuffer(), EPD_FRAME_BYTES) != 0);
+}
+
+// A minute tick only touches the rows of the clock digits (partial refresh window)
+static void test_minute_tick_stays_in_clock_rows()
+{
+    ClockFaceText text = sampleText();
+    clockFaceRender(frame, text, cfg);
+    memcpy(previous, frame.getBuffer(), EPD_FRAME_BYTES);
+    text.time = "12:35";
+    clockFaceRender(frame, text, cfg);
+
+    int first = -1, last = -1;
+    for (int y = 0; y < EPD_FRAME_HEIGHT; y++)
+    {
+        if (memcmp(previous + y * EPD_FRAME_STRIDE, frame.getBuffer() + y * EPD_FRAME_STRIDE, EPD_FRAME_STRIDE) == 0)
+            continue;
+        if (first < 0)
+            first = y;
+        last = y;
+    }
+    TEST_ASSERT_TRUE(first >= 0);
+    TEST_ASSERT_TRUE(first >= 90);
+    TEST_ASSERT_TRUE(last <= 132);
+}
+
+static void test_render_time()
+{
+    const ClockFaceText text = sampleText();
+    const int runs = 200;
+    const uint32_t start = micros();
+    for (int i = 0; i < runs; i++)
+        clockFaceRender(frame, text, cfg);
+    char msg[48];
+    snprintf(msg, sizeof(msg), "clockFaceRender: %lu us/frame", (unsigned long)((micros() - start) / runs));
+    TEST_MESSAGE(msg);
+}
+
+static void test_dump_pbm()
+{
+    ClockFaceText text = sampleText();
+    text.sleepIndicator = true;
+    clockFaceRender(frame, text, cfg);
+    const char *path = getenv("FRAME_PBM");
+    TEST_ASSERT_TRUE(writePbm(path ? path : ".pio/native_frame.pbm", frame.getBuffer()));
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_render_is_deterministic);
+    RUN_TEST(test_minute_tick_stays_in_clock_rows);
+    RUN_TEST(test_render_time);
+    RUN_TEST(test_dump_pbm);
+    return UNITY_END();
+}
@@ -0,0 +1,104 @@
+// Host checks of the oversampling pipeline against the traces checked in next to this file:
+// median_trace.csv (sample bursts) and smooth_trace.csv (consecutive wakes)
+#include <unity.h>
+#include <string>
+#include <vector>
+#include "sensor_filter.h"
+
+void setUp() { filterReset(); }
+void tearDown() {}
+
+static std::string tracePath(const char *name)
+{
+    const std::string self = __FILE__;
+    const size_t slash = self.find_last_of('/');
+    return (slash == std::string::npos) ? name : self.substr(0, slash + 1) + name;
+}
+
+static SensorChannel parseChannel(const char *name)
+{
+    if (strcmp(name, "temp") == 0)
+        return SENSOR_TEMP;
+    if (strcmp(name, "humidity") == 0)
+        return SENSOR_HUMIDITY;
+    TEST_ASSERT_EQUAL_STRING("battery", name);
+    return SENSOR_BATTERY;
+}
+
+// Data lines of a trace split at commas; '#' lines are comments
+static std::vector<std::vector<std::string>> readTrace(const char *name)
+{
+    std::vector<std::vector<std::string>> rows;
+    FILE *f = fopen(tracePath(name).c_str(), "r");
+    TEST_ASSERT_NOT_NULL_MESSAGE(f, name);
+    char line[256];
+    while (fgets(line, sizeof(line), f))
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '#' || line[0] == '\0')
+            continue;
+        std::vector<std::string> fields;
+        for (char *tok = strtok(line, ","); tok; tok = strtok(nullptr, ","))
+            fields.push_back(tok);
+        rows.push_back(fields);
+    }
+    fclose(f);
+    TEST_ASSERT_TRUE(!rows.empty());
+    return rows;
+}
+
+static void assertValue(float expected, float actual, const char *trace, int row)
+{
+    char where[48];
+    snprintf(where, sizeof(where), "%s row %d", trace, row);
+    if (isnan(expected))
+        TEST_ASSERT_FLOAT_IS_NAN_MESSAGE(actual, where);
+    else
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.005f, expected, actual, where);
+}
+
+static void test_median_trace()
+{
+    int row = 0;
+    for (const auto &fields : readTrace("median_trace.csv"))
+    {
+        row++;
+        TEST_ASSERT_TRUE(fields.size() >= 3 && fields.size() - 2 <= FILTER_MAX_SAMPLES);
+        float samples[FILTER_MAX_SAMPLES];
+        const size_t n = fields.size() - 2;
+        for (size_t i = 0; i < n; i++)
+            samples[i] = strtof(fields[i + 2].c_str(), nullptr);
+        const SensorChannel ch = parseChannel(fields[0].c_str());
+        assertValue(strtof(fields[1].c_str(), nullptr), filterMedian(samples, n, filterBounds(ch)), "median", row);
+    }
+}
+
+static void test_smooth_trace()
+{
+    int row = 0;
+    for (const auto &fields : readTrace("smooth_trace.csv"))
+    {
+        row++;
+        TEST_ASSERT_EQUAL_size_t(5, fields.size());
+        const SensorChannel ch = parseChannel(fields[0].c_str());
+        const float alpha = strtof(fields[1].c_str(), nullptr);
+        const uint32_t epoch = strtoul(fields[2].c_str(), nullptr, 10);
+        const float median = strtof(fields[3].c_str(), nullptr);
+        assertValue(strtof(fields[4].c_str(), nullptr), filterSmooth(ch, median, alpha, epoch), "smooth", row);
+    }
+}
+
+static void test_no_reading_before_the_first_sample()
+{
+    TEST_ASSERT_TRUE(isnan(filterSmooth(SENSOR_TEMP, NAN, 0.3f, 0)));
+    TEST_ASSERT_EQUAL_FLOAT(21.5f, filterSmooth(SENSOR_TEMP, 21.5f, 0.3f, 0));
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_median_trace);
+    RUN_TEST(test_smooth_trace);
+    RUN_TEST(test_no_reading_before_the_first_sample);
+    return UNITY_END();
+}
@@ -0,0 +1,48 @@
+// Host checks of the allocation-free number formatters used on the clock face
+#include <unity.h>
+#include "text_format.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void test_format_uint_pads_and_truncates()
+{
+    char out[8];
+    TEST_ASSERT_EQUAL_size_t(2, formatUint(out, sizeof(out), 7, 2));
+    TEST_ASSERT_EQUAL_STRING("07", out);
+    TEST_ASSERT_EQUAL_size_t(3, formatUint(out, 4, 4294967295UL));
+    TEST_ASSERT_EQUAL_STRING("429", out);
+}
+
+static void test_format_fixed_rounds_like_dtostrf()
+{
+    char out[16];
+    formatFixed(out, sizeof(out), 21.45f, 1);
+    TEST_ASSERT_EQUAL_STRING("21.5", out);
+    formatFixed(out, sizeof(out), -0.04f, 1);
+    TEST_ASSERT_EQUAL_STRING("0.0", out);
+    formatFixed(out, sizeof(out), -3.25f, 1);
+    TEST_ASSERT_EQUAL_STRING("-3.3", out);
+    formatFixed(out, sizeof(out), 48.0f, 0);
+    TEST_ASSERT_EQUAL_STRING("48", out);
+}
+
+static void test_format_fixed_without_a_value()
+{
+    char out[16];
+    TEST_ASSERT_EQUAL_size_t(2, formatFixed(out, sizeof(out), NAN, 1));
+    TEST_ASSERT_EQUAL_STRING("--", out);
+    formatFixed(out, sizeof(out), INFINITY, 1);
+    TEST_ASSERT_EQUAL_STRING("--", out);
+    formatFixed(out, sizeof(out), -3.0e9f, 0);
+    TEST_ASSERT_EQUAL_STRING("--", out);
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_format_uint_pads_and_truncates);
+    RUN_TEST(test_format_fixed_rounds_like_dtostrf);
+    RUN_TEST(test_format_fixed_without_a_value);
+    return UNITY_END();
+}
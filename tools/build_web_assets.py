@@ -0,0 +1,96 @@
+"""Build the LittleFS image contents from data/ into .pio/webfs.
+
+For every file in data/ the output holds:
+  <name>       the file itself (HTML gets cache-busted css/js references)
+  <name>.gz    gzip variant served when the browser accepts it
+  <name>.etag  content hash, used by the web server as strong ETag
+
+Local stylesheet/script references in HTML are rewritten to "/file.css?v=<hash>"
+so css/js can be served with Cache-Control: immutable while a firmware update
+still reaches the browser.
+
+Runs as a PlatformIO pre script (extra_scripts; platformio.ini points data_dir
+at the output) or standalone:
+    python tools/build_web_assets.py
+Outputs are only rewritten when their content changes.
+"""
+
+import gzip
+import hashlib
+import os
+import re
+
+HASH_LEN = 16
+REF_RE = re.compile(r'(href|src)="(/[^"?#]+\.(?:css|js))"')
+
+
+def content_hash(data):
+    return hashlib.sha256(data).hexdigest()[:HASH_LEN]
+
+
+def write_if_changed(path, data):
+    if os.path.exists(path):
+        with open(path, "rb") as f:
+            if f.read() == data:
+                return False
+    with open(path, "wb") as f:
+        f.write(data)
+    return True
+
+
+def gzip_bytes(data):
+    # mtime=0 keeps the output (and the filesystem image) reproducible
+    return gzip.compress(data, compresslevel=9, mtime=0)
+
+
+def build(project_dir):
+    src_dir = os.path.join(project_dir, "data")
+    out_dir = os.path.join(project_dir, ".pio", "webfs")
+    os.makedirs(out_dir, exist_ok=True)
+
+    names = sorted(n for n in os.listdir(src_dir) if os.path.isfile(os.path.join(src_dir, n)))
+    sources = {}
+    for name in names:
+        with open(os.path.join(src_dir, name), "rb") as f:
+            sources[name] = f.read()
+
+    # Non-HTML first: HTML references carry their hashes
+    hashes = {n: content_hash(d) for n, d in sources.items() if not n.endswith(".html")}
+
+    def bust(match):
+        name = match.group(2).lstrip("/")
+        if name not in hashes:
+            return match.group(0)
+        return '%s="/%s?v=%s"' % (match.group(1), name, hashes[name][:8])
+
+    produced = set()
+    changed = 0
+    for name in names:
+        data = sources[name]
+        if name.endswith(".html"):
+            data = REF_RE.sub(bust, data.decode("utf-8")).encode("utf-8")
+        outputs = {
+            name: data,
+            name + ".gz": gzip_bytes(data),
+            name + ".etag": content_hash(data).encode("ascii"),
+        }
+        for out_name, out_data in outputs.items():
+            produced.add(out_name)
+            if write_if_changed(os.path.join(out_dir, out_name), out_data):
+                changed += 1
+
+    for stale in set(os.listdir(out_dir)) - produced:
+        os.remove(os.path.join(out_dir, stale))
+
+    if changed:
+        raw = sum(len(d) for d in sources.values())
+        gz = sum(os.path.getsize(os.path.join(out_dir, n + ".gz")) for n in names)
+        print("build_web_assets: %d files, %d -> %d bytes gzipped (%s)" % (len(names), raw, gz, out_dir))
+
+
+try:
+    Import("env")  # noqa: F821 (PlatformIO / SCons)
+    build(env.subst("$PROJECT_DIR"))  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        build(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
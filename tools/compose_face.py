@@ -0,0 +1,288 @@
+"""Pre-composite the static clock face into src/face_layer.h.
+
+Replays the background bitmap plus every fixed primitive and label of the
+clock face (thermometer, humidity drops, battery frame, DATE/day boxes, ...)
+with the same pixel rules as Adafruit GFX, and writes the result as one 1bpp
+layer in frame layout (1 = white). clockFaceRender() then starts each refresh by
+copying this layer and only draws the dynamic content on top.
+
+Runs as a PlatformIO pre-build script (extra_scripts) or standalone:
+    python tools/compose_face.py
+The header is only rewritten when its content changes.
+"""
+
+import os
+import re
+
+WIDTH = 200
+HEIGHT = 200
+BLACK = False
+WHITE = True
+
+
+class Canvas:
+    """Minimal Adafruit_GFX emulation (rotation 0, text size 1, wrap on)."""
+
+    def __init__(self):
+        self.px = [[WHITE] * WIDTH for _ in range(HEIGHT)]
+        self.font = None
+        self.color = BLACK
+        self.cx = 0
+        self.cy = 0
+
+    def pixel(self, x, y, c):
+        if 0 <= x < WIDTH and 0 <= y < HEIGHT:
+            self.px[y][x] = c
+
+    def vline(self, x, y, h, c):
+        for yy in range(y, y + h):
+            self.pixel(x, yy, c)
+
+    def hline(self, x, y, w, c):
+        for xx in range(x, x + w):
+            self.pixel(xx, y, c)
+
+    def fill_rect(self, x, y, w, h, c):
+        for xx in range(x, x + w):
+            self.vline(xx, y, h, c)
+
+    def draw_rect(self, x, y, w, h, c):
+        self.hline(x, y, w, c)
+        self.hline(x, y + h - 1, w, c)
+        self.vline(x, y, h, c)
+        self.vline(x + w - 1, y, h, c)
+
+    def draw_bitmap(self, x, y, bitmap, w, h, c):
+        byte_width = (w + 7) // 8
+        for j in range(h):
+            for i in range(w):
+                if bitmap[j * byte_width + i // 8] & (0x80 >> (i & 7)):
+                    self.pixel(x + i, y + j, c)
+
+    def _circle_helper(self, x0, y0, r, corners, delta, c):
+        f = 1 - r
+        ddf_x = 1
+        ddf_y = -2 * r
+        x = 0
+        y = r
+        px = x
+        py = y
+        delta += 1
+        while x < y:
+            if f >= 0:
+                y -= 1
+                ddf_y += 2
+                f += ddf_y
+            x += 1
+            ddf_x += 2
+            f += ddf_x
+            if x < y + 1:
+                if corners & 1:
+                    self.vline(x0 + x, y0 - y, 2 * y + delta, c)
+                if corners & 2:
+                    self.vline(x0 - x, y0 - y, 2 * y + delta, c)
+            if y != py:
+                if corners & 1:
+                    self.vline(x0 + py, y0 - px, 2 * px + delta, c)
+                if corners & 2:
+                    self.vline(x0 - py, y0 - px, 2 * px + delta, c)
+                py = y
+            px = x
+
+    def fill_circle(self, x0, y0, r, c):
+        self.vline(x0, y0 - r, 2 * r + 1, c)
+        self._circle_helper(x0, y0, r, 3, 0, c)
+
+    def fill_round_rect(self, x, y, w, h, r, c):
+        r = min(r, min(w, h) // 2)
+        self.fill_rect(x + r, y, w - 2 * r, h, c)
+        self._circle_helper(x + w - r - 1, y + r, r, 1, h - 2 * r - 1, c)
+        self._circle_helper(x + r, y + r, r, 2, h - 2 * r - 1, c)
+
+    def _glyph(self, ch):
+        bitmaps, glyphs, first, last, _ = self.font
+        code = ord(ch)
+        if code < first or code > last:
+            return None
+        return glyphs[code - first]
+
+    def text_bounds(self, text, x, y):
+        _, _, _, _, y_advance = self.font
+        minx, miny, maxx, maxy = 0x7FFF, 0x7FFF, -1, -1
+        for ch in text:
+            g = self._glyph(ch)
+            if g is None:
+                continue
+            _, gw, gh, xa, xo, yo = g
+            if x + xo + gw > WIDTH:
+                x = 0
+                y += y_advance
+            x1 = x + xo
+            y1 = y + yo
+            minx = min(minx, x1)
+            miny = min(miny, y1)
+            maxx = max(maxx, x1 + gw - 1)
+            maxy = max(maxy, y1 + gh - 1)
+            x += xa
+        bx, by, bw, bh = x, y, 0, 0
+        if maxx >= minx:
+            bx, bw = minx, maxx - minx + 1
+        if maxy >= miny:
+            by, bh = miny, maxy - miny + 1
+        return bx, by, bw, bh
+
+    def print(self, text):
+        bitmaps, _, _, _, y_advance = self.font
+        for ch in text:
+            g = self._glyph(ch)
+            if g is None:
+                continue
+            bo, w, h, xa, xo, yo = g
+            if w > 0 and h > 0:
+                if self.cx + xo + w > WIDTH:
+                    self.cx = 0
+                    self.cy += y_advance
+                bit = 0
+                bits = 0
+                for yy in range(h):
+                    for xx in range(w):
+                        if not bit & 7:
+                            bits = bitmaps[bo]
+                            bo += 1
+                        bit += 1
+                        if bits & 0x80:
+                            self.pixel(self.cx + xo + xx, self.cy + yo + yy, self.color)
+                        bits = (bits << 1) & 0xFF
+            self.cx += xa
+
+    def clear_text_area(self, text, x, y, pad, c=WHITE):
+        bx, by, bw, bh = self.text_bounds(text, x, y)
+        rx, ry = max(bx - pad, 0), max(by - pad, 0)
+        rw, rh = bw + pad * 2, bh + pad * 2
+        rw = min(rw, WIDTH - rx)
+        rh = min(rh, HEIGHT - ry)
+        self.fill_rect(rx, ry, rw, rh, c)
+
+    def pack(self):
+        out = bytearray()
+        for row in self.px:
+            for col in range(0, WIDTH, 8):
+                b = 0
+                for i in range(8):
+                    if row[col + i]:
+                        b |= 0x80 >> i
+                out.append(b)
+        return bytes(out)
+
+
+def _array_body(src, name):
+    m = re.search(re.escape(name) + r"\s*\[\]\s*PROGMEM\s*=\s*\{(.*?)\};", src, re.S)
+    if not m:
+        raise RuntimeError("array %s not found" % name)
+    return re.sub(r"//[^\n]*", "", m.group(1))
+
+
+def load_bitmap(src, name):
+    return [int(v, 16) for v in re.findall(r"0x[0-9A-Fa-f]+", _array_body(src, name))]
+
+
+def load_font(src, name):
+    bitmaps = load_bitmap(src, name + "Bitmaps")
+    glyphs = [tuple(int(v) for v in g)
+              for g in re.findall(r"\{\s*(-?\d+),\s*(-?\d+),\s*(-?\d+),\s*(-?\d+),\s*(-?\d+),\s*(-?\d+)\s*\}",
+                                  _array_body(src, name + "Glyphs"))]
+    m = re.search(r"GFXfont\s+" + re.escape(name) + r"\s+PROGMEM\s*=\s*\{[^}]*?,\s*(0x[0-9A-Fa-f]+|\d+),\s*"
+                  r"(0x[0-9A-Fa-f]+|\d+),\s*(\d+)\s*\}", src, re.S)
+    if not m:
+        raise RuntimeError("font %s not found" % name)
+    return bitmaps, glyphs, int(m.group(1), 0), int(m.group(2), 0), int(m.group(3))
+
+
+def compose(src_dir):
+    with open(os.path.join(src_dir, "background.h")) as f:
+        back_image = load_bitmap(f.read(), "backImage")
+    with open(os.path.join(src_dir, "fonts.h")) as f:
+        font15 = load_font(f.read(), "DejaVu_Sans_Condensed_Bold_15")
+
+    g = Canvas()
+    g.draw_bitmap(0, 0, back_image, 200, 200, BLACK)
+
+    g.fill_rect(60, 137, 124, 5, BLACK)
+    g.fill_rect(120, 82, 60, 2, BLACK)
+    g.fill_rect(10, 42, 3, 129, BLACK)
+
+    # Battery frame (segments are drawn per refresh)
+    g.draw_rect(150, 8, 40, 16, BLACK)
+    g.draw_rect(151, 9, 38, 14, BLACK)
+    g.fill_rect(190, 12, 3, 7, BLACK)
+
+    # DATE box
+    g.fill_round_rect(20, 40, 95, 45, 5, BLACK)
+
+    # Thermometer
+    g.fill_round_rect(35, 143, 15, 40, 8, BLACK)
+    g.fill_circle(42, 173, 10, BLACK)
+    g.fill_round_rect(37, 145, 11, 36, 8, WHITE)
+    g.fill_circle(42, 173, 8, WHITE)
+    g.fill_round_rect(40, 153, 5, 25, 2, BLACK)
+    g.fill_circle(42, 173, 5, BLACK)
+
+    # Humidity drops
+    for i in range(6):
+        g.fill_circle(122, 170 - (i * 3), 6 - i, BLACK)
+
+    # Day-of-week box
+    g.fill_round_rect(152, 94, 30, 22, 4, BLACK)
+
+    # Static labels
+    g.font = font15
+    g.color = WHITE
+    g.cx, g.cy = 27, 57
+    g.print("DATE")
+
+    g.color = BLACK
+    g.clear_text_area("TEMP", 60, 161, 2)
+    g.cx, g.cy = 60, 161
+    g.print("TEMP")
+    g.clear_text_area("HUM", 135, 161, 2)
+    g.cx, g.cy = 135, 161
+    g.print("HUM")
+
+    return g.pack()
+
+
+def render_header(layer):
+    lines = [
+        "#pragma once",
+        "#include <Arduino.h>",
+        "",
+        "// Generated by tools/compose_face.py from background.h and the static clock face",
+        "// primitives/labels. Do not edit by hand.",
+        "// 200x200 1bpp, 1 = white, 25 bytes per row (offscreen frame layout)",
+        "const uint8_t faceLayer[] PROGMEM = {",
+    ]
+    for i in range(0, len(layer), 16):
+        lines.append("    " + ", ".join("0x%02X" % b for b in layer[i:i + 16]) + ",")
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def generate(project_dir):
+    src_dir = os.path.join(project_dir, "src")
+    out_path = os.path.join(src_dir, "face_layer.h")
+    content = render_header(compose(src_dir))
+    if os.path.exists(out_path):
+        with open(out_path) as f:
+            if f.read() == content:
+                return
+    with open(out_path, "w", newline="\n") as f:
+        f.write(content)
+    print("compose_face: wrote %s" % out_path)
+
+
+try:
+    Import("env")  # noqa: F821 (PlatformIO / SCons)
+    generate(env.subst("$PROJECT_DIR"))  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        generate(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))